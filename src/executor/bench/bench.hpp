@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace venus {
+namespace bench {
+
+using clock_t = std::chrono::steady_clock;
+
+/**
+ * @brief Latency percentiles in nanoseconds.
+ */
+struct percentiles
+{
+    double m_p50 = 0;
+    double m_p99 = 0;
+    double m_p999 = 0;
+    double m_max = 0;
+};
+
+/**
+ * @brief Collects latency samples, one per measured operation.
+ *
+ * Each thread records into its own samples, merge() combines them before they are summarized.
+ */
+class samples
+{
+public:
+    explicit samples(std::size_t expected = 0);
+
+    void add(clock_t::duration duration);
+    void merge(const samples & other);
+
+    [[nodiscard]] std::size_t size() const;
+    [[nodiscard]] percentiles summarize() const;
+
+private:
+    std::vector<std::int64_t> m_nanoseconds;
+};
+
+/**
+ * @brief The outcome of one benchmark.
+ *
+ * m_operations operations took m_elapsed in total, m_latency summarizes the per-operation samples.
+ */
+struct result
+{
+    std::string m_name;
+    std::string m_parameters; // for example "producers=4"
+    std::size_t m_operations = 0;
+    clock_t::duration m_elapsed = {};
+    percentiles m_latency;
+};
+
+/**
+ * @brief Selects the benchmarks to run and collects their results.
+ */
+class reporter
+{
+public:
+    reporter(std::string filter, bool quick);
+
+    /**
+     * @brief Checks whether the benchmark named @p name should run, that is when its name contains the filter.
+     */
+    [[nodiscard]] bool enabled(const std::string & name) const;
+
+    /**
+     * @brief Scales @p operations down in the quick mode, which smoke-tests the benchmarks; its numbers are not meaningful.
+     */
+    [[nodiscard]] std::size_t operations(std::size_t operations) const;
+
+    void add(result result);
+
+    void print_table() const;
+    void print_json() const;
+
+private:
+    std::string m_filter;
+    bool m_quick;
+    std::vector<result> m_results;
+};
+
+void executor_benchmarks(reporter & reporter);
+void scheduled_calls_benchmarks(reporter & reporter);
+void synchronized_queue_benchmarks(reporter & reporter);
+void guarded_benchmarks(reporter & reporter);
+
+} // namespace bench
+} // namespace venus
@@ -0,0 +1,356 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#include "bench.hpp"
+
+#include "executor/clock.hpp"
+#include "executor/executor.hpp"
+#include "executor/timer_service.hpp"
+
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fmt/core.h>
+
+using namespace std::chrono_literals;
+
+namespace venus {
+namespace bench {
+
+namespace {
+
+// @p producers threads add() tasks concurrently, the elapsed time ends when the executor has run them all.
+// With an @p upstream resource the queue nodes come from the arena of the executor.
+void add_throughput(reporter & reporter, std::size_t producers, memory_resource * upstream)
+{
+    auto per_producer = reporter.operations(1'000'000) / producers;
+    std::vector<samples> latencies(producers, samples(per_producer));
+    std::size_t executed = 0;
+
+    executor_options options;
+    options.m_memory_resource = upstream;
+    venus::executor executor(options);
+    auto start = clock_t::now();
+    std::vector<std::thread> threads;
+    for (std::size_t p = 0; p < producers; ++p)
+    {
+        threads.emplace_back([&, p] {
+            for (std::size_t i = 0; i < per_producer; ++i)
+            {
+                auto before = clock_t::now();
+                executor.add([&executed] { ++executed; });
+                latencies[p].add(clock_t::now() - before);
+            }
+        });
+    }
+    for (auto & thread : threads)
+    {
+        thread.join();
+    }
+    executor.synchronize();
+
+    result result;
+    result.m_name = "executor.add";
+    result.m_parameters = fmt::format("producers={}{}", producers, upstream != nullptr ? " arena" : "");
+    result.m_operations = executed;
+    result.m_elapsed = clock_t::now() - start;
+    for (std::size_t p = 1; p < producers; ++p)
+    {
+        latencies[0].merge(latencies[p]);
+    }
+    result.m_latency = latencies[0].summarize();
+    reporter.add(std::move(result));
+}
+
+// @p producers threads are released at the same time and add() their tasks back-to-back, without timing each one,
+// so they contend on the queue and, with an @p upstream resource, on the free lists of the arena of the executor.
+void add_contended(reporter & reporter, std::size_t producers, memory_resource * upstream)
+{
+    auto per_producer = reporter.operations(1'000'000) / producers;
+    std::size_t executed = 0;
+
+    executor_options options;
+    options.m_memory_resource = upstream;
+    venus::executor executor(options);
+    std::promise<void> start_signal;
+    auto started = start_signal.get_future().share();
+    std::vector<std::thread> threads;
+    for (std::size_t p = 0; p < producers; ++p)
+    {
+        threads.emplace_back([&, started] {
+            started.wait();
+            for (std::size_t i = 0; i < per_producer; ++i)
+            {
+                executor.add([&executed] { ++executed; });
+            }
+        });
+    }
+
+    auto start = clock_t::now();
+    start_signal.set_value();
+    for (auto & thread : threads)
+    {
+        thread.join();
+    }
+    executor.synchronize();
+
+    result result;
+    result.m_name = "executor.add.contended";
+    result.m_parameters = fmt::format("producers={}{}", producers, upstream != nullptr ? " arena" : "");
+    result.m_operations = executed;
+    result.m_elapsed = clock_t::now() - start;
+    reporter.add(std::move(result));
+}
+
+// the time between entering call() and returning with the result, the executor is idle in between calls.
+void call_round_trip(reporter & reporter, const executor_options & options, const char * parameters)
+{
+    auto count = reporter.operations(100'000);
+    samples latencies(count);
+
+    venus::executor executor(options);
+    auto start = clock_t::now();
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        auto before = clock_t::now();
+        executor.call([i] { return i; });
+        latencies.add(clock_t::now() - before);
+    }
+
+    result result;
+    result.m_name = "executor.call";
+    result.m_parameters = parameters;
+    result.m_operations = count;
+    result.m_elapsed = clock_t::now() - start;
+    result.m_latency = latencies.summarize();
+    reporter.add(std::move(result));
+}
+
+// the time between entering call_async() and the future becoming ready, includes the packaged_task and future overhead.
+void call_async_round_trip(reporter & reporter)
+{
+    auto count = reporter.operations(100'000);
+    samples latencies(count);
+
+    venus::executor executor;
+    auto start = clock_t::now();
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        auto before = clock_t::now();
+        executor.call_async([i] { return i; }).get();
+        latencies.add(clock_t::now() - before);
+    }
+
+    result result;
+    result.m_name = "executor.call_async";
+    result.m_operations = count;
+    result.m_elapsed = clock_t::now() - start;
+    result.m_latency = latencies.summarize();
+    reporter.add(std::move(result));
+}
+
+// the lateness of call_after() timers, how long after their deadline they run, with random delays up to @p maximum_delay.
+// A non-zero @p precision_window measures the precision timer mode.
+void call_after_lateness(reporter & reporter, duration_t maximum_delay, duration_t precision_window)
+{
+    auto count = reporter.operations(10'000);
+    samples lateness(count); // only used by the executor thread
+    std::promise<void> done;
+
+    std::mt19937 random(42);
+    std::uniform_int_distribution<std::int64_t> microseconds(0, std::chrono::duration_cast<std::chrono::microseconds>(maximum_delay).count());
+
+    executor_options options;
+    options.m_precision_window = precision_window;
+    venus::executor executor(options);
+    auto start = clock_t::now();
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        auto delay = std::chrono::microseconds(microseconds(random));
+        auto deadline = clock_t::now() + delay;
+        executor.call_after(delay, [&, deadline] {
+            lateness.add(clock_t::now() - deadline);
+            if (lateness.size() == count)
+            {
+                done.set_value();
+            }
+        });
+    }
+    done.get_future().wait();
+
+    result result;
+    result.m_name = "executor.call_after.lateness";
+    result.m_parameters = fmt::format("delay<={}ms", std::chrono::duration_cast<std::chrono::milliseconds>(maximum_delay).count());
+    if (precision_window != duration_t::zero())
+    {
+        result.m_parameters += fmt::format(" precision={}us", std::chrono::duration_cast<std::chrono::microseconds>(precision_window).count());
+    }
+    result.m_operations = count;
+    result.m_elapsed = clock_t::now() - start;
+    result.m_latency = lateness.summarize();
+    reporter.add(std::move(result));
+}
+
+// the lateness of heartbeats, @p executors executors each run a call_every(10ms), with their own timers or a shared timer_service.
+void heartbeat_lateness(reporter & reporter, std::size_t executors, timer_service * service)
+{
+    auto ticks = reporter.operations(100);
+    std::vector<samples> lateness(executors, samples(ticks)); // one per executor thread
+    std::vector<std::promise<void>> done(executors);
+
+    executor_options options;
+    options.m_timer_service = service;
+    std::vector<std::unique_ptr<venus::executor>> pool;
+    std::vector<scheduled_call> calls;
+    auto start = clock_t::now();
+    for (std::size_t e = 0; e < executors; ++e)
+    {
+        pool.push_back(std::make_unique<venus::executor>(options));
+        auto & executor = *pool.back();
+        calls.push_back(executor.call_every(start + 10ms, 10ms, [&, e] {
+            if (lateness[e].size() == ticks)
+            {
+                return;
+            }
+            lateness[e].add(executor.lateness());
+            if (lateness[e].size() == ticks)
+            {
+                done[e].set_value();
+            }
+        }));
+    }
+    for (auto & d : done)
+    {
+        d.get_future().wait();
+    }
+    auto elapsed = clock_t::now() - start;
+    for (auto & call : calls)
+    {
+        call.cancel();
+    }
+    pool.clear();
+
+    for (std::size_t e = 1; e < executors; ++e)
+    {
+        lateness[0].merge(lateness[e]);
+    }
+
+    result result;
+    result.m_name = "executor.call_every.heartbeats";
+    result.m_parameters = fmt::format("executors={}{}", executors, service != nullptr ? " timer_service" : "");
+    result.m_operations = lateness[0].size();
+    result.m_elapsed = elapsed;
+    result.m_latency = lateness[0].summarize();
+    reporter.add(std::move(result));
+}
+
+// @p timers call_every() timers with random intervals of 100ms to 10s run for @p simulated time on a manual_clock that
+// is advanced in steps of 10ms, the latency is the wall time of one step; the same seed gives exactly the same run.
+void simulated_timers(reporter & reporter, std::size_t timers, duration_t simulated)
+{
+    std::mt19937 random(42);
+    std::uniform_int_distribution<std::int64_t> milliseconds(100, 10'000);
+    auto steps = static_cast<std::size_t>(simulated / 10ms);
+    samples latencies(steps);
+    std::size_t ticks = 0; // only used by the executor thread
+
+    manual_clock clock;
+    executor_options options;
+    options.m_clock = &clock;
+    venus::executor executor(options);
+    std::vector<scheduled_call> calls;
+    for (std::size_t i = 0; i < timers; ++i)
+    {
+        auto interval = std::chrono::milliseconds(milliseconds(random));
+        calls.push_back(executor.call_every(clock.now() + interval, interval, [&ticks] { ++ticks; }));
+    }
+
+    auto start = clock_t::now();
+    for (std::size_t i = 0; i < steps; ++i)
+    {
+        auto before = clock_t::now();
+        clock.advance(10ms);
+        latencies.add(clock_t::now() - before);
+    }
+    auto elapsed = clock_t::now() - start;
+    for (auto & call : calls)
+    {
+        call.cancel();
+    }
+    executor.synchronize();
+
+    result result;
+    result.m_name = "executor.call_every.simulated";
+    result.m_parameters = fmt::format("timers={} simulated={}s", timers, std::chrono::duration_cast<std::chrono::seconds>(simulated).count());
+    result.m_operations = ticks;
+    result.m_elapsed = elapsed;
+    result.m_latency = latencies.summarize();
+    reporter.add(std::move(result));
+}
+
+} // namespace
+
+void executor_benchmarks(reporter & reporter)
+{
+    if (reporter.enabled("executor.add"))
+    {
+        for (std::size_t producers : {1u, 2u, 4u, 8u})
+        {
+            add_throughput(reporter, producers, nullptr);
+            add_throughput(reporter, producers, new_delete_resource());
+        }
+    }
+
+    if (reporter.enabled("executor.add.contended"))
+    {
+        for (std::size_t producers : {2u, 4u, 8u, 16u})
+        {
+            add_contended(reporter, producers, nullptr);
+            add_contended(reporter, producers, new_delete_resource());
+        }
+    }
+
+    if (reporter.enabled("executor.call"))
+    {
+        executor_options busy_poll;
+        busy_poll.m_busy_poll = true;
+        executor_options reactor;
+        reactor.m_reactor = true;
+        call_round_trip(reporter, executor_options(), "");
+        call_round_trip(reporter, busy_poll, "busy_poll");
+        call_round_trip(reporter, reactor, "reactor");
+    }
+
+    if (reporter.enabled("executor.call_async"))
+    {
+        call_async_round_trip(reporter);
+    }
+
+    if (reporter.enabled("executor.call_after.lateness"))
+    {
+        call_after_lateness(reporter, 10ms, duration_t::zero());
+        call_after_lateness(reporter, 1s, duration_t::zero());
+        call_after_lateness(reporter, 1s, 100us);
+    }
+
+    if (reporter.enabled("executor.call_every.simulated"))
+    {
+        simulated_timers(reporter, 10'000, std::chrono::seconds(reporter.operations(600)));
+    }
+
+    if (reporter.enabled("executor.call_every.heartbeats"))
+    {
+        timer_service service;
+        heartbeat_lateness(reporter, 16, nullptr);
+        heartbeat_lateness(reporter, 16, &service);
+    }
+}
+
+} // namespace bench
+} // namespace venus
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#include "bench.hpp"
+
+#include "executor/guarded.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <fmt/core.h>
+
+using namespace std::chrono_literals;
+
+namespace venus {
+namespace bench {
+
+namespace {
+
+// a small read-mostly record, like a configuration or a routing entry
+struct config
+{
+    std::uint64_t m_version = 0;
+    std::uint64_t m_values[7] = {};
+};
+
+/**
+ * @brief @p readers threads each call @p read in a loop, while one writer calls @p write every 100us.
+ */
+template <typename Read, typename Write>
+void read_mostly(reporter & reporter, const char * name, std::size_t readers, Read read, Write write)
+{
+    auto per_reader = reporter.operations(1'000'000) / readers;
+    std::vector<samples> latencies(readers, samples(per_reader));
+    std::atomic<std::size_t> running = {readers};
+    std::atomic<std::uint64_t> checksum = {0};
+
+    auto start = clock_t::now();
+    std::thread writer([&] {
+        while (running != 0)
+        {
+            write();
+            std::this_thread::sleep_for(100us);
+        }
+    });
+
+    std::vector<std::thread> threads;
+    for (std::size_t r = 0; r < readers; ++r)
+    {
+        threads.emplace_back([&, r] {
+            std::uint64_t sum = 0;
+            for (std::size_t i = 0; i < per_reader; ++i)
+            {
+                auto before = clock_t::now();
+                sum += read();
+                latencies[r].add(clock_t::now() - before);
+            }
+            checksum += sum;
+            --running;
+        });
+    }
+    for (auto & thread : threads)
+    {
+        thread.join();
+    }
+    auto elapsed = clock_t::now() - start;
+    writer.join();
+
+    for (std::size_t r = 1; r < readers; ++r)
+    {
+        latencies[0].merge(latencies[r]);
+    }
+
+    result result;
+    result.m_name = name;
+    result.m_parameters = fmt::format("readers={}", readers);
+    result.m_operations = latencies[0].size();
+    result.m_elapsed = elapsed;
+    result.m_latency = latencies[0].summarize();
+    reporter.add(std::move(result));
+}
+
+std::uint64_t sum(const config & data)
+{
+    std::uint64_t total = data.m_version;
+    for (auto value : data.m_values)
+    {
+        total += value;
+    }
+    return total;
+}
+
+void bump(config & data)
+{
+    ++data.m_version;
+    for (auto & value : data.m_values)
+    {
+        ++value;
+    }
+}
+
+} // namespace
+
+void guarded_benchmarks(reporter & reporter)
+{
+    for (std::size_t readers : {1u, 2u, 4u, 8u})
+    {
+        if (reporter.enabled("guarded_notify.with_lock"))
+        {
+            guarded_notify<config> data;
+            read_mostly(
+                reporter, "guarded_notify.with_lock", readers, [&] { return data.with_lock([](config & c) { return sum(c); }); },
+                [&] { data.with_lock([](config & c) { bump(c); }); });
+        }
+
+        if (reporter.enabled("guarded.with_shared_lock"))
+        {
+            guarded<config> data;
+            read_mostly(
+                reporter, "guarded.with_shared_lock", readers, [&] { return data.with_shared_lock([](const config & c) { return sum(c); }); },
+                [&] { data.with_unique_lock([](config & c) { bump(c); }); });
+        }
+
+        if (reporter.enabled("guarded_snapshot.snapshot"))
+        {
+            guarded_snapshot<config> data;
+            read_mostly(
+                reporter, "guarded_snapshot.snapshot", readers, [&] { return sum(*data.snapshot()); },
+                [&] { data.update([](config & c) { bump(c); }); });
+        }
+
+        if (reporter.enabled("guarded_seqlock.load"))
+        {
+            guarded_seqlock<config> data;
+            read_mostly(
+                reporter, "guarded_seqlock.load", readers, [&] { return sum(data.load()); }, [&] { data.update([](config & c) { bump(c); }); });
+        }
+    }
+}
+
+} // namespace bench
+} // namespace venus
@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#include "bench.hpp"
+
+#include "executor/scheduled_calls.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include <fmt/core.h>
+
+using namespace std::chrono_literals;
+
+namespace venus {
+namespace bench {
+
+namespace {
+
+// the implementation of venus::scheduled_calls before the timing wheel, a vector sorted in descending order, as a baseline
+class vector_scheduled_calls
+{
+public:
+    void assign(std::vector<call_t> && calls)
+    {
+        m_calls = std::move(calls);
+        std::sort(m_calls.begin(), m_calls.end(), later);
+    }
+
+    bool empty() const
+    {
+        return m_calls.empty();
+    }
+
+    void insert(call_t && call)
+    {
+        m_calls.insert(std::lower_bound(m_calls.begin(), m_calls.end(), call, later), std::move(call));
+    }
+
+    void remove(call_t::id_t id)
+    {
+        auto it = std::find_if(m_calls.begin(), m_calls.end(), [id](const call_t & call) { return call.m_id == id; });
+        if (it != m_calls.end())
+        {
+            m_calls.erase(it);
+        }
+    }
+
+    time_point_t next_deadline() const
+    {
+        return m_calls.back().m_at;
+    }
+
+    call_t pop_and_reschedule()
+    {
+        call_t call(std::move(m_calls.back()));
+        m_calls.pop_back();
+        return call;
+    }
+
+private:
+    static bool later(const call_t & a, const call_t & b)
+    {
+        return a.m_at > b.m_at;
+    }
+
+    std::vector<call_t> m_calls;
+};
+
+void fill(scheduled_calls & calls, std::vector<call_t> && added)
+{
+    for (auto & call : added)
+    {
+        calls.insert(std::move(call));
+    }
+}
+
+void fill(vector_scheduled_calls & calls, std::vector<call_t> && added)
+{
+    calls.assign(std::move(added));
+}
+
+void add_result(reporter & reporter, const char * name, const char * backend, std::size_t count, const samples & latencies, clock_t::duration elapsed)
+{
+    result result;
+    result.m_name = name;
+    result.m_parameters = fmt::format("{} calls={}", backend, count);
+    result.m_operations = latencies.size();
+    result.m_elapsed = elapsed;
+    result.m_latency = latencies.summarize();
+    reporter.add(std::move(result));
+}
+
+// with @p count calls with random deadlines within a minute scheduled, measures inserting @p measured more calls,
+// removing @p measured random calls and popping @p measured calls. Filling in the first @p count calls is not measured,
+// so the sorted vector can be measured at 10^6 calls too.
+template <typename Calls>
+void insert_remove_pop(reporter & reporter, const char * backend, std::size_t count, std::size_t measured)
+{
+    std::mt19937 random(42);
+    std::uniform_int_distribution<std::int64_t> microseconds(0, 60'000'000);
+    auto make_call = [&](std::size_t index) {
+        return call_t(static_cast<call_t::id_t>(index + 1), time_point_t() + 1h + std::chrono::microseconds(microseconds(random)), {});
+    };
+
+    Calls calls;
+    std::vector<call_t> initial;
+    initial.reserve(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        initial.push_back(make_call(i));
+    }
+    fill(calls, std::move(initial));
+
+    std::vector<call_t> added;
+    added.reserve(measured);
+    for (std::size_t i = 0; i < measured; ++i)
+    {
+        added.push_back(make_call(count + i));
+    }
+
+    std::vector<call_t::id_t> removed;
+    std::uniform_int_distribution<call_t::id_t> ids(1, count + measured);
+    for (std::size_t i = 0; i < measured; ++i)
+    {
+        removed.push_back(ids(random));
+    }
+
+    samples inserts(measured);
+    auto start = clock_t::now();
+    for (auto & call : added)
+    {
+        auto before = clock_t::now();
+        calls.insert(std::move(call));
+        inserts.add(clock_t::now() - before);
+    }
+    auto inserted = clock_t::now();
+    add_result(reporter, "scheduled_calls.insert", backend, count, inserts, inserted - start);
+
+    samples removes(measured);
+    for (auto id : removed)
+    {
+        auto before = clock_t::now();
+        calls.remove(id);
+        removes.add(clock_t::now() - before);
+    }
+    auto removed_all = clock_t::now();
+    add_result(reporter, "scheduled_calls.remove", backend, count, removes, removed_all - inserted);
+
+    samples pops(measured);
+    for (std::size_t i = 0; i < measured && !calls.empty(); ++i)
+    {
+        auto before = clock_t::now();
+        (void)calls.next_deadline();
+        calls.pop_and_reschedule();
+        pops.add(clock_t::now() - before);
+    }
+    add_result(reporter, "scheduled_calls.pop", backend, count, pops, clock_t::now() - removed_all);
+}
+
+} // namespace
+
+void scheduled_calls_benchmarks(reporter & reporter)
+{
+    if (!reporter.enabled("scheduled_calls.insert") && !reporter.enabled("scheduled_calls.remove") && !reporter.enabled("scheduled_calls.pop"))
+    {
+        return;
+    }
+
+    // the timing wheel and the sorted vector it replaced, side by side at every size
+    for (std::size_t count : {1'000u, 10'000u, 100'000u, 1'000'000u})
+    {
+        auto measured = reporter.operations(std::min<std::size_t>(count, 10'000));
+        insert_remove_pop<scheduled_calls>(reporter, "wheel", reporter.operations(count), measured);
+        insert_remove_pop<vector_scheduled_calls>(reporter, "vector", reporter.operations(count), measured);
+    }
+}
+
+} // namespace bench
+} // namespace venus
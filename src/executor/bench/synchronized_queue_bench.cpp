@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#include "bench.hpp"
+
+#include "executor/synchronized_queue.hpp"
+
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include <fmt/core.h>
+
+namespace venus {
+namespace bench {
+
+namespace {
+
+// @p producers threads push into a queue of @p maximum_size, one consumer pops, so push and pop contend for the lock.
+void push_pop_contention(reporter & reporter, std::size_t producers, std::size_t maximum_size)
+{
+    auto per_producer = reporter.operations(1'000'000) / producers;
+    std::vector<samples> pushes(producers, samples(per_producer));
+    samples pops(per_producer * producers);
+
+    synchronized_queue<std::size_t> queue(maximum_size);
+    auto start = clock_t::now();
+    std::thread consumer([&] {
+        for (std::size_t i = 0; i < per_producer * producers; ++i)
+        {
+            auto before = clock_t::now();
+            (void)queue.pop();
+            pops.add(clock_t::now() - before);
+        }
+    });
+
+    std::vector<std::thread> threads;
+    for (std::size_t p = 0; p < producers; ++p)
+    {
+        threads.emplace_back([&, p] {
+            for (std::size_t i = 0; i < per_producer; ++i)
+            {
+                auto before = clock_t::now();
+                queue.push(i);
+                pushes[p].add(clock_t::now() - before);
+            }
+        });
+    }
+    for (auto & thread : threads)
+    {
+        thread.join();
+    }
+    consumer.join();
+    auto elapsed = clock_t::now() - start;
+
+    for (std::size_t p = 1; p < producers; ++p)
+    {
+        pushes[0].merge(pushes[p]);
+    }
+
+    auto parameters = fmt::format("producers={} max={}", producers, maximum_size);
+    result push_result;
+    push_result.m_name = "synchronized_queue.push";
+    push_result.m_parameters = parameters;
+    push_result.m_operations = pushes[0].size();
+    push_result.m_elapsed = elapsed;
+    push_result.m_latency = pushes[0].summarize();
+    reporter.add(std::move(push_result));
+
+    result pop_result;
+    pop_result.m_name = "synchronized_queue.pop";
+    pop_result.m_parameters = parameters;
+    pop_result.m_operations = pops.size();
+    pop_result.m_elapsed = elapsed;
+    pop_result.m_latency = pops.summarize();
+    reporter.add(std::move(pop_result));
+}
+
+} // namespace
+
+void synchronized_queue_benchmarks(reporter & reporter)
+{
+    if (!reporter.enabled("synchronized_queue.push") && !reporter.enabled("synchronized_queue.pop"))
+    {
+        return;
+    }
+
+    for (std::size_t producers : {1u, 2u, 4u, 8u})
+    {
+        push_pop_contention(reporter, producers, 0);
+        push_pop_contention(reporter, producers, 1024);
+    }
+}
+
+} // namespace bench
+} // namespace venus
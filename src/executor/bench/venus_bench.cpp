@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+// Micro-benchmarks of the executor and queue hot paths.
+//
+// usage: venus_bench [--json] [--quick] [filter]
+//
+//   --json   print the results as one JSON document instead of a table, to track regressions between releases
+//   --quick  run every benchmark with few operations, to check that they work
+//   filter   only run the benchmarks whose name contains this text, for example "executor.call"
+
+#include "bench.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+#include <fmt/core.h>
+
+namespace venus {
+namespace bench {
+
+samples::samples(std::size_t expected)
+{
+    m_nanoseconds.reserve(expected);
+}
+
+void samples::add(clock_t::duration duration)
+{
+    m_nanoseconds.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+}
+
+void samples::merge(const samples & other)
+{
+    m_nanoseconds.insert(m_nanoseconds.end(), other.m_nanoseconds.begin(), other.m_nanoseconds.end());
+}
+
+std::size_t samples::size() const
+{
+    return m_nanoseconds.size();
+}
+
+percentiles samples::summarize() const
+{
+    percentiles result;
+    if (m_nanoseconds.empty())
+    {
+        return result;
+    }
+
+    auto sorted = m_nanoseconds;
+    std::sort(sorted.begin(), sorted.end());
+    auto at = [&](double fraction) {
+        auto index = static_cast<std::size_t>(std::ceil(fraction * static_cast<double>(sorted.size()))) - 1;
+        return static_cast<double>(sorted[std::min(index, sorted.size() - 1)]);
+    };
+    result.m_p50 = at(0.5);
+    result.m_p99 = at(0.99);
+    result.m_p999 = at(0.999);
+    result.m_max = static_cast<double>(sorted.back());
+    return result;
+}
+
+reporter::reporter(std::string filter, bool quick) :
+    m_filter(std::move(filter)),
+    m_quick(quick)
+{
+}
+
+bool reporter::enabled(const std::string & name) const
+{
+    return name.find(m_filter) != std::string::npos;
+}
+
+std::size_t reporter::operations(std::size_t operations) const
+{
+    return m_quick ? std::max<std::size_t>(operations / 100, 1) : operations;
+}
+
+void reporter::add(result result)
+{
+    fmt::print(stderr, "{} {} done\n", result.m_name, result.m_parameters);
+    m_results.push_back(std::move(result));
+}
+
+namespace {
+
+double seconds(clock_t::duration duration)
+{
+    return std::chrono::duration<double>(duration).count();
+}
+
+double operations_per_second(const result & result)
+{
+    auto elapsed = seconds(result.m_elapsed);
+    return elapsed > 0 ? static_cast<double>(result.m_operations) / elapsed : 0;
+}
+
+} // namespace
+
+void reporter::print_table() const
+{
+    fmt::print("{:<34} {:<16} {:>10} {:>12} {:>10} {:>10} {:>10} {:>10}\n", "benchmark", "parameters", "operations", "ops/s", "p50 ns", "p99 ns", "p999 ns", "max ns");
+    for (auto & result : m_results)
+    {
+        fmt::print("{:<34} {:<16} {:>10} {:>12.0f} {:>10.0f} {:>10.0f} {:>10.0f} {:>10.0f}\n",
+            result.m_name,
+            result.m_parameters,
+            result.m_operations,
+            operations_per_second(result),
+            result.m_latency.m_p50,
+            result.m_latency.m_p99,
+            result.m_latency.m_p999,
+            result.m_latency.m_max);
+    }
+}
+
+void reporter::print_json() const
+{
+    // names and parameters are fixed identifiers without characters that need escaping
+    fmt::print("{{\n  \"benchmarks\": [");
+    const char * separator = "\n";
+    for (auto & result : m_results)
+    {
+        fmt::print("{}    {{\"name\": \"{}\", \"parameters\": \"{}\", \"operations\": {}, \"seconds\": {:.6f}, \"ops_per_second\": {:.0f}, "
+                   "\"p50_ns\": {:.0f}, \"p99_ns\": {:.0f}, \"p999_ns\": {:.0f}, \"max_ns\": {:.0f}}}",
+            separator,
+            result.m_name,
+            result.m_parameters,
+            result.m_operations,
+            seconds(result.m_elapsed),
+            operations_per_second(result),
+            result.m_latency.m_p50,
+            result.m_latency.m_p99,
+            result.m_latency.m_p999,
+            result.m_latency.m_max);
+        separator = ",\n";
+    }
+    fmt::print("\n  ]\n}}\n");
+}
+
+} // namespace bench
+} // namespace venus
+
+int main(int argc, char * argv[])
+{
+    bool json = false;
+    bool quick = false;
+    std::string filter;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--json") == 0)
+        {
+            json = true;
+        }
+        else if (std::strcmp(argv[i], "--quick") == 0)
+        {
+            quick = true;
+        }
+        else if (argv[i][0] == '-')
+        {
+            fmt::print(stderr, "usage: {} [--json] [--quick] [filter]\n", argv[0]);
+            return 1;
+        }
+        else
+        {
+            filter = argv[i];
+        }
+    }
+
+    venus::bench::reporter reporter(filter, quick);
+    venus::bench::executor_benchmarks(reporter);
+    venus::bench::scheduled_calls_benchmarks(reporter);
+    venus::bench::synchronized_queue_benchmarks(reporter);
+    venus::bench::guarded_benchmarks(reporter);
+
+    if (json)
+    {
+        reporter.print_json();
+    }
+    else
+    {
+        reporter.print_table();
+    }
+    return 0;
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#pragma once
+
+#include "executor/scheduled_calls.hpp"
+
+namespace venus {
+
+/**
+ * @brief The awaitable returned by `executor.schedule()`, `co_await executor.schedule()` continues the coroutine on @p Executor.
+ *
+ * The awaitables only need the coroutine handle in await_suspend(), which is a template, so they can be declared in the
+ * C++14 headers and are only instantiated by C++20 code that uses co_await, see executor/coroutine.hpp.
+ *
+ * A coroutine that is waiting on an executor that is destroyed before the task runs, is never resumed and its frame leaks.
+ */
+template <typename Executor>
+class schedule_awaitable
+{
+public:
+    explicit schedule_awaitable(Executor & executor) :
+        m_executor(executor)
+    {
+    }
+
+    [[nodiscard]] bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    template <typename Handle>
+    void await_suspend(Handle handle) const
+    {
+        m_executor.add([handle]() { handle.resume(); });
+    }
+
+    void await_resume() const noexcept
+    {
+    }
+
+    [[nodiscard]] Executor & executor() const
+    {
+        return m_executor;
+    }
+
+private:
+    Executor & m_executor;
+};
+
+/**
+ * @brief The awaitable returned by `executor.after(delay)`, it continues the coroutine on @p Executor once @p delay has passed.
+ *
+ * The coroutine is resumed by a scheduled call of the executor, so no thread blocks while it waits.
+ */
+template <typename Executor>
+class after_awaitable
+{
+public:
+    after_awaitable(Executor & executor, duration_t delay) :
+        m_executor(executor),
+        m_delay(delay)
+    {
+    }
+
+    [[nodiscard]] bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    template <typename Handle>
+    void await_suspend(Handle handle) const
+    {
+        m_executor.call_after(m_delay, [handle]() { handle.resume(); });
+    }
+
+    void await_resume() const noexcept
+    {
+    }
+
+    [[nodiscard]] Executor & executor() const
+    {
+        return m_executor;
+    }
+
+private:
+    Executor & m_executor;
+    duration_t m_delay;
+};
+
+} // namespace venus
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace venus {
+
+/**
+ * @brief Id-indexed table with the cancellation state of scheduled calls.
+ *
+ * An id consists of a slot index (low 32 bits) and the generation of that slot (high 32 bits).
+ * cancel() is a single compare-and-swap on the slot, so any thread can cancel a call without blocking
+ * and without involving the executor thread. When the executor is done with a call it release()s the id,
+ * which moves the slot to the next generation, so a late cancel() of an old id does not affect the call
+ * that re-uses the slot.
+ *
+ * Slots are allocated in chunks that are never moved or freed while the table exists.
+ * All functions are lock-free and may be called from any thread, but every id is released by one thread, once.
+ */
+class call_handles
+{
+public:
+    using id_t = std::uint64_t;
+
+    static constexpr std::size_t chunk_size = 4096;
+    static constexpr std::size_t max_chunks = 4096; // at most 16M calls can be scheduled at the same time
+
+    call_handles();
+    ~call_handles();
+
+    call_handles(const call_handles &) = delete;
+    call_handles & operator=(const call_handles &) = delete;
+
+    /**
+     * @brief Returns a new, active id.
+     *
+     * @throws std::length_error when chunk_size * max_chunks ids are in use.
+     */
+    [[nodiscard]] id_t acquire();
+
+    /**
+     * @brief Marks @p id as cancelled.
+     *
+     * @return `true` if @p id was active; `false` if it was already cancelled or released.
+     */
+    bool cancel(id_t id);
+
+    /**
+     * @brief Checks that @p id was neither cancelled nor released.
+     */
+    [[nodiscard]] bool active(id_t id) const;
+
+    /**
+     * @brief Makes the slot of @p id available for re-use, every acquired id must be released exactly once.
+     */
+    void release(id_t id);
+
+    /**
+     * @brief Attaches @p value to @p id, like the id of the same call in a venus::timer_service, release() clears it.
+     */
+    void link(id_t id, std::uint64_t value);
+
+    /**
+     * @brief The value attached to @p id with link(), 0 when nothing is attached or @p id was released.
+     */
+    [[nodiscard]] std::uint64_t linked(id_t id) const;
+
+    /**
+     * @brief The number of ids that were cancelled but not released yet.
+     */
+    [[nodiscard]] std::size_t cancelled_count() const;
+
+private:
+    struct slot
+    {
+        // (generation << 1) | cancelled
+        std::atomic<std::uint64_t> m_state = {0};
+        // index + 1 of the next free slot, 0 terminates the free list
+        std::atomic<std::uint32_t> m_next_free = {0};
+        std::atomic<std::uint64_t> m_link = {0};
+    };
+
+    slot * find(std::uint32_t index) const;
+    slot & get_or_create(std::uint32_t index);
+
+    std::unique_ptr<std::atomic<slot *>[]> m_chunks;
+
+    // lock-free stack of released slots: (tag << 32) | (index + 1), the tag prevents ABA
+    std::atomic<std::uint64_t> m_free_head = {0};
+    std::atomic<std::uint32_t> m_size = {0};
+    std::atomic<std::size_t> m_cancelled = {0};
+};
+
+} // namespace venus
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#pragma once
+
+#include "executor/scheduled_calls.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace venus {
+
+/**
+ * @brief The time source of the scheduled calls of a venus::executor, see executor_options::m_clock.
+ *
+ * The time points have the type of std::chrono::steady_clock, so call_at(), call_after() and lateness() keep their
+ * types, but a clock_source decides what "now" is and how long the executor thread sleeps for a deadline.
+ * Task statistics, like the queue wait and task duration in executor_stats, are always measured in real time.
+ */
+class clock_source
+{
+public:
+    using listener_t = std::function<std::future<void>()>;
+
+    virtual ~clock_source() = default;
+
+    [[nodiscard]] virtual time_point_t now() const = 0;
+
+    /**
+     * @brief The steady_clock time point at which now() reaches @p deadline, the executor thread sleeps until then.
+     *
+     * time_point_t::max() for a clock that only moves when it is told to, that clock calls its listeners instead.
+     */
+    [[nodiscard]] virtual time_point_t steady_time(time_point_t deadline) const = 0;
+
+    /**
+     * @brief Calls @p listener whenever the time jumps, until unsubscribe() is called with the same @p owner.
+     *
+     * The listener must not block: it posts the due calls of its owner and returns a future that is ready once they ran,
+     * or an invalid future when it is called on the thread of its owner.
+     */
+    virtual void subscribe(const void * owner, listener_t listener) = 0;
+    virtual void unsubscribe(const void * owner) = 0;
+};
+
+/**
+ * @brief A clock that only moves when advance() or advance_to() is called, to test and simulate timer logic
+ * without sleeping: an hour of call_every() ticks runs in milliseconds, in exactly the same order every time.
+ *
+ * advance_to() posts the due calls to every executor that uses the clock, then returns when they have run,
+ * including calls that those calls scheduled at or before the new time.
+ * When it is called on the thread of one of those executors, it does not wait: another executor can be blocked on the
+ * calling task, and the executor of the calling task runs its due calls only after that task returns.
+ *
+ * @note advance_to() must not be called from another thread that one of the executors is blocked on, it would wait
+ * for that executor forever. An executor using the clock must not be destroyed from a scheduled call that runs
+ * during advance_to().
+ */
+class manual_clock : public clock_source
+{
+public:
+    explicit manual_clock(time_point_t start = time_point_t());
+
+    [[nodiscard]] time_point_t now() const override;
+    [[nodiscard]] time_point_t steady_time(time_point_t deadline) const override;
+    void subscribe(const void * owner, listener_t listener) override;
+    void unsubscribe(const void * owner) override;
+
+    /**
+     * @brief Moves the time forward to @p to, a @p to in the past is ignored, the time never moves back.
+     */
+    void advance_to(time_point_t to);
+    void advance(duration_t duration);
+
+private:
+    struct subscription
+    {
+        const void * m_owner;
+        listener_t m_listener;
+        std::atomic<int> m_calls = {0}; // advance_to() calls that are calling the listener, unsubscribe() waits for them
+    };
+
+    std::atomic<duration_t::rep> m_now; // since the epoch of time_point_t
+
+    // the listeners are called without holding the mutex, so a listener can advance the clock itself
+    std::mutex m_mutex;
+    std::vector<std::shared_ptr<subscription>> m_subscriptions;
+};
+
+/**
+ * @brief A clock that runs @p speed times as fast as std::chrono::steady_clock, to replay recorded timer load
+ * faster (or slower) than real time. It starts at the steady_clock time of its construction.
+ *
+ * steady_time() is always a finite time point, a deadline that is too far away to represent is at most a day away.
+ */
+class scaled_clock : public clock_source
+{
+public:
+    explicit scaled_clock(double speed);
+
+    [[nodiscard]] time_point_t now() const override;
+    [[nodiscard]] time_point_t steady_time(time_point_t deadline) const override;
+    void subscribe(const void * owner, listener_t listener) override;
+    void unsubscribe(const void * owner) override;
+
+private:
+    static constexpr duration_t longest_wait = std::chrono::hours(24); // steady_time() is never further away
+
+    const double m_speed;
+    const time_point_t m_start;
+};
+
+} // namespace venus
@@ -0,0 +1,438 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#pragma once
+
+// The coroutine layer is optional, the rest of the library stays C++14, only code that includes this header needs C++20.
+#if !defined(__cpp_impl_coroutine)
+#error "executor/coroutine.hpp requires C++20 coroutines, compile with -std=c++20"
+#endif
+
+#include "executor/awaitables.hpp"
+#include "executor/executor.hpp"
+#include "executor/future.hpp"
+#include "executor/pool_executor.hpp"
+#include "executor/strand.hpp"
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace venus {
+
+template <typename T = void>
+class task;
+
+namespace detail {
+
+inline bool is_current(const executor & executor)
+{
+    return executor.is_executor_thread();
+}
+
+inline bool is_current(const pool_executor & pool)
+{
+    return pool.is_pool_thread();
+}
+
+inline bool is_current(const strand & strand)
+{
+    return strand.is_current_strand();
+}
+
+/**
+ * @brief A type-erased reference to the executor a coroutine is running on, empty if it is not known.
+ */
+class resume_target
+{
+public:
+    resume_target() = default;
+
+    template <typename Executor>
+    static resume_target of(Executor & executor)
+    {
+        resume_target target;
+        target.m_executor = &executor;
+        target.m_resume = [](void * erased, std::coroutine_handle<> handle) {
+            static_cast<Executor *>(erased)->add([handle]() { handle.resume(); });
+        };
+        target.m_is_current = [](const void * erased) { return detail::is_current(*static_cast<const Executor *>(erased)); };
+        return target;
+    }
+
+    [[nodiscard]] bool empty() const
+    {
+        return m_executor == nullptr;
+    }
+
+    [[nodiscard]] bool is_current() const
+    {
+        return m_is_current(m_executor);
+    }
+
+    void resume(std::coroutine_handle<> handle) const
+    {
+        m_resume(m_executor, handle);
+    }
+
+private:
+    void * m_executor = nullptr;
+    void (*m_resume)(void *, std::coroutine_handle<>) = nullptr;
+    bool (*m_is_current)(const void *) = nullptr;
+};
+
+/**
+ * @brief The part of the promise of a venus::task that keeps track of the executor the coroutine is running on.
+ *
+ * `co_await executor.schedule()` and `co_await executor.after()` move the coroutine to that executor, an awaited task
+ * starts on the executor of the coroutine that awaits it.
+ */
+class executor_affinity
+{
+public:
+    template <typename Executor>
+    schedule_awaitable<Executor> await_transform(schedule_awaitable<Executor> awaitable)
+    {
+        m_executor = resume_target::of(awaitable.executor());
+        return awaitable;
+    }
+
+    template <typename Executor>
+    after_awaitable<Executor> await_transform(after_awaitable<Executor> awaitable)
+    {
+        m_executor = resume_target::of(awaitable.executor());
+        return awaitable;
+    }
+
+    template <typename U>
+    auto await_transform(task<U> && awaited)
+    {
+        return std::move(awaited).awaited_on(m_executor);
+    }
+
+    template <typename Awaitable>
+    Awaitable && await_transform(Awaitable && awaitable)
+    {
+        return std::forward<Awaitable>(awaitable);
+    }
+
+protected:
+    resume_target m_executor;
+};
+
+/**
+ * @brief The promise of a venus::task<T>, it stores the result and resumes the coroutine that awaits the task.
+ */
+template <typename T>
+class task_promise_base : public executor_affinity
+{
+public:
+    task<T> get_return_object();
+
+    std::suspend_always initial_suspend() const noexcept
+    {
+        return {};
+    }
+
+    auto final_suspend() const noexcept
+    {
+        struct final_awaiter
+        {
+            bool await_ready() const noexcept
+            {
+                return false;
+            }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<>) noexcept
+            {
+                auto continuation = m_promise->m_continuation;
+                auto resume_on = m_promise->m_resume_on;
+                if (!continuation)
+                {
+                    return std::noop_coroutine();
+                }
+                if (resume_on.empty() || resume_on.is_current())
+                {
+                    return continuation;
+                }
+
+                // the awaiting coroutine destroys this frame when it resumes on the other thread, so only locals are used here
+                resume_on.resume(continuation);
+                return std::noop_coroutine();
+            }
+
+            void await_resume() const noexcept
+            {
+            }
+
+            const task_promise_base * m_promise;
+        };
+        return final_awaiter{this};
+    }
+
+    void unhandled_exception()
+    {
+        m_result.template emplace<std::exception_ptr>(std::current_exception());
+    }
+
+    /**
+     * @brief Starts the coroutine as the continuation of @p awaiting, on @p executor if it is not empty.
+     */
+    void awaited_by(std::coroutine_handle<> awaiting, const resume_target & executor)
+    {
+        m_continuation = awaiting;
+        m_resume_on = executor;
+        m_executor = executor;
+    }
+
+protected:
+    std::variant<std::monostate, stored_t<T>, std::exception_ptr> m_result;
+
+    stored_t<T> take()
+    {
+        if (auto exception = std::get_if<std::exception_ptr>(&m_result))
+        {
+            std::rethrow_exception(*exception);
+        }
+        return std::move(std::get<stored_t<T>>(m_result));
+    }
+
+private:
+    std::coroutine_handle<> m_continuation;
+    resume_target m_resume_on;
+};
+
+template <typename T>
+class task_promise : public task_promise_base<T>
+{
+public:
+    template <typename U>
+    void return_value(U && value)
+    {
+        this->m_result.template emplace<T>(std::forward<U>(value));
+    }
+
+    T result()
+    {
+        return this->take();
+    }
+};
+
+template <>
+class task_promise<void> : public task_promise_base<void>
+{
+public:
+    void return_void()
+    {
+        m_result.emplace<unit>();
+    }
+
+    void result()
+    {
+        take();
+    }
+};
+
+/**
+ * @brief A fire-and-forget coroutine that destroys itself when it completes, used by venus::spawn().
+ */
+struct detached
+{
+    struct promise_type : executor_affinity
+    {
+        detached get_return_object() const noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never initial_suspend() const noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never final_suspend() const noexcept
+        {
+            return {};
+        }
+
+        void return_void() const noexcept
+        {
+        }
+
+        void unhandled_exception() const noexcept
+        {
+            std::terminate();
+        }
+    };
+};
+
+} // namespace detail
+
+/**
+ * @brief A lazily started coroutine that produces a @p T, await it from another task with `co_await`, or start it with venus::spawn().
+ *
+ * A task has executor affinity: it starts on the executor of the coroutine that awaits it, and when it completes the
+ * awaiting coroutine continues on that same executor, also if the task moved itself to another executor with
+ * `co_await other.schedule()`. Switching between tasks on the same executor is a direct jump, it does not allocate.
+ *
+ * Example, a multi-step flow without a std::function or std::packaged_task per step:
+ *
+ *     venus::task<int> load(venus::executor & executor, venus::pool_executor & pool)
+ *     {
+ *         co_await pool.schedule();
+ *         auto data = crunch();             // on a pool thread
+ *         co_await executor.after(10ms);
+ *         co_return store(data);            // on the executor thread
+ *     }
+ *
+ * An exception thrown in the task is rethrown by the `co_await` that awaits it.
+ */
+template <typename T>
+class [[nodiscard]] task
+{
+public:
+    using promise_type = detail::task_promise<T>;
+
+    task(task && other) noexcept :
+        m_handle(std::exchange(other.m_handle, {}))
+    {
+    }
+
+    task(const task &) = delete;
+    task & operator=(const task &) = delete;
+
+    task & operator=(task && other) noexcept
+    {
+        if (this != &other)
+        {
+            destroy();
+            m_handle = std::exchange(other.m_handle, {});
+        }
+        return *this;
+    }
+
+    ~task()
+    {
+        destroy();
+    }
+
+    /**
+     * @brief The awaiter used by `co_await task`, @p executor is the executor of the awaiting coroutine.
+     */
+    auto awaited_on(const detail::resume_target & executor) &&
+    {
+        struct awaiter
+        {
+            bool await_ready() const noexcept
+            {
+                return false;
+            }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+            {
+                m_task.m_handle.promise().awaited_by(awaiting, m_executor);
+                return m_task.m_handle;
+            }
+
+            T await_resume()
+            {
+                return m_task.m_handle.promise().result();
+            }
+
+            task m_task;
+            detail::resume_target m_executor;
+        };
+        return awaiter{std::move(*this), executor};
+    }
+
+    // awaited by a coroutine that is not a venus::task, it continues on the thread that completes the task
+    auto operator co_await() &&
+    {
+        return std::move(*this).awaited_on(detail::resume_target());
+    }
+
+private:
+    friend class detail::task_promise_base<T>;
+
+    explicit task(std::coroutine_handle<promise_type> handle) :
+        m_handle(handle)
+    {
+    }
+
+    void destroy()
+    {
+        if (m_handle)
+        {
+            m_handle.destroy();
+            m_handle = {};
+        }
+    }
+
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+template <typename T>
+task<T> detail::task_promise_base<T>::get_return_object()
+{
+    return task<T>(std::coroutine_handle<task_promise<T>>::from_promise(static_cast<task_promise<T> &>(*this)));
+}
+
+namespace detail {
+
+template <typename Executor, typename T>
+detached spawn_on(Executor & executor, task<T> started, promise<T> result)
+{
+    co_await executor.schedule();
+
+    std::optional<stored_t<T>> value;
+    std::exception_ptr exception;
+    try
+    {
+        if constexpr (std::is_void_v<T>)
+        {
+            co_await std::move(started);
+            value.emplace();
+        }
+        else
+        {
+            value.emplace(co_await std::move(started));
+        }
+    }
+    catch (...)
+    {
+        exception = std::current_exception();
+    }
+
+    // outside of the try block, an exception thrown by a continuation of the future must not complete it twice
+    if (exception)
+    {
+        result.set_exception(exception);
+    }
+    else
+    {
+        result.set_value(std::move(*value));
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief Starts @p started on @p executor and returns a venus::future for its result.
+ *
+ * This is the bridge from callback code to coroutines: `venus::spawn(executor, flow()).get()` waits for the result,
+ * `.then(fn)` continues without blocking. @p executor can be a venus::executor, venus::pool_executor or venus::strand.
+ */
+template <typename Executor, typename T>
+future<T> spawn(Executor & executor, task<T> started)
+{
+    promise<T> result;
+    auto completed = result.get_future();
+    detail::spawn_on(executor, std::move(started), std::move(result));
+    return completed;
+}
+
+} // namespace venus
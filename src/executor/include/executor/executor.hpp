@@ -4,9 +4,22 @@
 
 #pragma once
 
+#include "executor/awaitables.hpp"
+#include "executor/call_handles.hpp"
+#include "executor/clock.hpp"
+#include "executor/executor_stats.hpp"
+#include "executor/memory_resource.hpp"
+#include "executor/mpsc_queue.hpp"
+#include "executor/parker.hpp"
+#include "executor/priority.hpp"
+#include "executor/reactor.hpp"
+#include "executor/rendezvous.hpp"
 #include "executor/scheduled_calls.hpp"
-#include "executor/synchronized_queue.hpp"
+#include "executor/spin_wait.hpp"
+#include "executor/thread_options.hpp"
+#include "executor/timer_service.hpp"
 
+#include <array>
 #include <cassert>
 #include <chrono>
 #include <cstdint>
@@ -22,9 +35,15 @@ class executor;
 class scheduled_call
 {
 public:
-    using id_t = std::uint32_t;
+    using id_t = call_t::id_t;
 
     scheduled_call(venus::executor & executor, scheduled_call::id_t id);
+
+    /**
+     * @brief Cancels the call, this never blocks, also not when called from another thread than the executor thread.
+     *
+     * From another thread, a call that the executor thread is starting at that moment, can still run once.
+     */
     void cancel();
 
     [[nodiscard]] scheduled_call::id_t id() const;
@@ -34,12 +53,65 @@ private:
     scheduled_call::id_t m_id;
 };
 
-[[nodiscard]] scheduled_call::id_t make_callid();
+/**
+ * @brief Returns a new, process-wide unique id.
+ *
+ * @deprecated the executor does not use these ids anymore, a call gets its id from the executor that schedules it,
+ * see scheduled_call::id(). Kept so code that still calls it compiles.
+ */
+[[deprecated("call ids are assigned by the executor, see scheduled_call::id()")]] [[nodiscard]] scheduled_call::id_t make_callid();
+
+/**
+ * @brief Construction options of a venus::executor.
+ */
+struct executor_options
+{
+    // how long the executor thread spins for new work before it sleeps
+    spin_policy m_spin;
+
+    // the executor thread never sleeps, it polls for work and timers, so a task is picked up within a few hundred
+    // nanoseconds and producers never make a system call. This keeps one core 100% busy, use it for an executor
+    // that is pinned to a dedicated core.
+    bool m_busy_poll = false;
+
+    // the executor thread sleeps in epoll_wait, so it can wait on file descriptors, see executor::watch().
+    // Producers wake it through an eventfd and the next scheduled call is a timerfd, m_busy_poll is ignored in this mode.
+    bool m_reactor = false;
+
+    // precision timer mode: the executor thread wakes up this long before the deadline of a scheduled call and spins
+    // until the deadline, so the wakeup latency of the scheduler does not make it late. 50-100us typically gives a
+    // lateness of a few microseconds, at the cost of one core spinning for this window before every deadline.
+    // Zero (the default) sleeps until the deadline.
+    duration_t m_precision_window = duration_t::zero();
+
+    // name, cpu affinity and scheduling of the executor thread, for example to pin a latency-critical executor
+    // to a core that the pool threads do not use.
+    thread_options m_thread;
+
+    // the scheduled calls are kept by this shared venus::timer_service instead of the executor itself, when they are due
+    // the service adds them to the executor as tasks, so the executor thread sleeps without a deadline.
+    // The service must outlive the executor, m_precision_window does not apply to these calls.
+    timer_service * m_timer_service = nullptr;
+
+    // when set, the executor owns a venus::slab_resource on top of this resource, the queue nodes, scheduled call entries
+    // and large closures of scheduled calls are recycled there instead of going through the global allocator.
+    // executor_stats::m_memory shows the counters. Null (the default) uses the global allocator.
+    memory_resource * m_memory_resource = nullptr;
+
+    // the time source of the scheduled calls, for example a venus::manual_clock that a test advances explicitly.
+    // Null (the default) is std::chrono::steady_clock. The clock must outlive the executor, it cannot be combined
+    // with m_timer_service.
+    clock_source * m_clock = nullptr;
+};
 
 class executor
 {
 public:
-    executor();
+    /**
+     * @throws std::system_error when @p options.m_thread cannot be applied to the executor thread.
+     * @throws std::invalid_argument when @p options has both a m_clock and a m_timer_service.
+     */
+    explicit executor(executor_options options = executor_options());
 
     /**
      * @brief The destructor of the executor ensures that any ongoing tasks initiated by call(), tasks scheduled via call_async, or
@@ -49,8 +121,14 @@ public:
      */
     ~executor();
 
+    /**
+     * @brief Runs @p fn on the executor thread and returns its result, or rethrows its exception, in the calling thread.
+     *
+     * @p fn is called by reference and the result is moved back through a rendezvous on the stack of the caller,
+     * so call() does not copy the callable or allocate shared state, only the queued task that refers to both.
+     */
     template <typename Fn>
-    auto call(Fn fn)
+    auto call(Fn && fn)
     {
         if (is_executor_thread())
         {
@@ -58,18 +136,18 @@ public:
             return fn();
         }
 
-        // A packaged_task encapsulates a task and its associated promise in one object.
-        std::packaged_task<decltype(fn())()> task(fn);
-        add([&task]() { task(); });
-        return task.get_future().get();
+        detail::rendezvous<decltype(fn())> done;
+        add([&fn, &done] { done.run(fn); });
+        return done.get();
     }
 
     template <typename Fn>
     auto call_async(Fn fn)
     {
-        auto pTask = std::make_shared<std::packaged_task<decltype(fn())()>>(fn);
-        auto f = pTask->get_future();
-        add([pTask]() { (*pTask)(); });
+        // unique_task is move-only, so the packaged_task is moved into the task instead of shared with it.
+        std::packaged_task<decltype(fn())()> task(std::move(fn));
+        auto f = task.get_future();
+        add([task = std::move(task)]() mutable { task(); });
         return f;
     }
 
@@ -92,39 +170,261 @@ public:
      * @brief Synchronizes the calling thread with the executor thread.
      *
      * Blocks the calling thread until it is synchronized with the executor thread.
-     * Ensures that all previously scheduled tasks are completed, providing a consistent
+     * Ensures that all previously scheduled tasks are completed, in all lanes, providing a consistent
      * state between the executor thread and the calling thread.
      */
     void synchronize();
 
-    void add(venus::function_t function);
+    /**
+     * @brief Adds @p function to the lane of priority @p lane.
+     *
+     * Tasks in the same lane are executed in the order they were added, a task in a higher lane is executed before
+     * the tasks in lower lanes. A lower lane that has been passed over `aging_limit` times gets one task executed
+     * next, so bulk work in the higher lanes delays it, but cannot starve it.
+     */
+    void add(venus::function_t function, priority lane = priority::normal);
+
+    /**
+     * @brief Adds all @p functions as one consecutive batch, tasks added concurrently by other threads are never interleaved with them.
+     *
+     * This costs a single atomic exchange and at most one wakeup of the executor thread for the whole batch.
+     */
+    void add_bulk(std::vector<venus::function_t> functions, priority lane = priority::normal);
+
+    /**
+     * @brief Cancels the scheduled call with @p id, this is lock-free and can be called from any thread.
+     *
+     * On the executor thread the call is removed immediately, otherwise it is only marked as cancelled
+     * and reclaimed lazily by the executor thread.
+     */
     void cancel(venus::call_t::id_t id);
 
-    scheduled_call call_at(const time_point_t & at, function_t function);
-    scheduled_call call_after(const duration_t & delay, function_t function);
-    scheduled_call call_every(const duration_t & repeat_interval, function_t function);
-    scheduled_call call_every(const time_point_t & at, const duration_t & repeat_interval, function_t function);
+    /**
+     * @brief Calls @p callback on the executor thread when @p fd is ready for @p events (EPOLLIN, EPOLLOUT, EPOLLET, ...),
+     * only in the reactor mode, see executor_options::m_reactor.
+     *
+     * The callback runs inline on the executor thread, in order with the tasks, so there is no handoff from an I/O thread.
+     * Watching an fd again replaces its events and callback. From another thread this blocks until the executor thread
+     * has registered the fd.
+     *
+     * @throws std::logic_error when the executor is not in the reactor mode.
+     * @throws std::system_error when epoll_ctl rejects @p fd.
+     */
+    void watch(int fd, std::uint32_t events, reactor::callback_t callback);
+
+    /**
+     * @brief Stops watching @p fd, once this returns its callback is not called anymore, call it before closing @p fd.
+     */
+    void unwatch(int fd);
+
+    /**
+     * @brief Takes a snapshot of the runtime statistics, this can be called from any thread.
+     */
+    [[nodiscard]] executor_stats stats() const;
+
+    /**
+     * @brief The arena of the executor, see executor_options::m_memory_resource, or null when it has none.
+     *
+     * Tasks can allocate large closures from it with `unique_task(std::allocator_arg, executor.arena(), fn)`.
+     */
+    [[nodiscard]] memory_resource * arena() const;
+
+    /**
+     * @brief Schedules @p function to run at @p at, after @p delay, or every @p repeat_interval.
+     *
+     * The call never runs before its deadline. A @p slack allows it to run up to @p slack later, so the executor can
+     * run all timers that are due within the same window in one wakeup, see venus::coalesce().
+     * This saves wakeups and context switches for large numbers of heartbeat and timeout timers.
+     */
+    scheduled_call call_at(const time_point_t & at, function_t function, const duration_t & slack = duration_t::zero());
+    scheduled_call call_after(const duration_t & delay, function_t function, const duration_t & slack = duration_t::zero());
+    scheduled_call call_every(const duration_t & repeat_interval, function_t function, const duration_t & slack = duration_t::zero());
+    scheduled_call call_every(const time_point_t & at, const duration_t & repeat_interval, function_t function, const duration_t & slack = duration_t::zero());
+
+    /**
+     * @brief Calls @p fn every @p repeat_interval, when ticks are missed @p policy decides whether they run late.
+     *
+     * @p fn is called with the number of missed ticks as a `std::size_t`: the ticks that were skipped or coalesced
+     * into this run, it is always 0 for missed_tick_policy::catch_up.
+     */
+    template <typename Fn>
+    scheduled_call call_every(const duration_t & repeat_interval, missed_tick_policy policy, Fn fn, const duration_t & slack = duration_t::zero())
+    {
+        call_t call(m_handles.acquire(), now(), repeat_interval, slack,
+            function_t(std::allocator_arg, m_arena.get(), [this, fn = std::move(fn)]() mutable { fn(m_missed_ticks); }));
+        call.m_missed_policy = policy;
+        return register_call(std::move(call));
+    }
+
+    /**
+     * @brief `co_await executor.schedule()` continues a C++20 coroutine on the executor thread, see executor/coroutine.hpp.
+     */
+    schedule_awaitable<executor> schedule()
+    {
+        return schedule_awaitable<executor>(*this);
+    }
+
+    /**
+     * @brief `co_await executor.after(delay)` continues a C++20 coroutine on the executor thread once @p delay has passed,
+     * it is a scheduled call, so no thread waits for it.
+     */
+    after_awaitable<executor> after(const duration_t & delay)
+    {
+        return after_awaitable<executor>(*this, delay);
+    }
+
+    /**
+     * @brief The current time of the scheduled calls: the time of executor_options::m_clock, or std::chrono::steady_clock.
+     */
+    [[nodiscard]] time_point_t now() const;
+
+    /**
+     * @brief The lateness of the scheduled call that is running: the time from its (coalesced) deadline until it started.
+     *
+     * Only valid on the executor thread, inside the function of a scheduled call. The lateness of all calls is
+     * recorded in executor_stats::m_lateness.
+     */
+    [[nodiscard]] duration_t lateness() const;
+
+    /**
+     * @brief The number of tasks of higher lanes that can be executed while a lower lane is waiting, before it gets a turn.
+     */
+    static constexpr std::size_t aging_limit = 64;
+
+    /**
+     * @brief The longest time the executor thread runs tasks without checking the watched file descriptors.
+     */
+    static constexpr std::chrono::microseconds reactor_poll_interval = std::chrono::microseconds(500);
 
 private:
-    bool wait_for_work(const time_point_t timepoint) const;
+    /**
+     * @brief A task in `m_lanes`, with the time it was added to measure how long it waited.
+     */
+    struct queued_task
+    {
+        function_t m_function;
+        time_point_t m_enqueued;
+    };
+
+    void wait_for_work();
+    bool wait_for_work(const time_point_t deadline);
+
+    /**
+     * @brief Wakes the executor thread after work was added, through `m_parker` or `m_reactor`.
+     */
+    void wake();
+
+    /**
+     * @brief In the reactor mode, calls the callbacks of ready file descriptors when the executor thread is so busy
+     * that it did not wait in epoll_wait for `reactor_poll_interval`, so tasks cannot starve I/O.
+     */
+    void poll_reactor(const time_point_t now);
 
     /**
-     * @brief Executes a single task from the executor's queue.
+     * @brief Adds @p function to every lane, so it runs once all tasks that were added before it, in any lane, have run.
+     */
+    void add_after_all_lanes(function_t function);
+
+    /**
+     * @brief Takes the next task from the highest non-empty lane, or from a lower lane whose turn it is.
+     */
+    bool try_pop_task(queued_task & task, priority & lane);
+
+    [[nodiscard]] bool lanes_empty() const;
+
+    /**
+     * @brief Executes the tasks from the executor's lanes, or a single scheduled call.
      *
-     * Processes exactly one task or function.
+     * All tasks that are available in `m_lanes` are executed as one batch before `m_scheduled_calls` is checked again.
+     * When there are no tasks, at most one scheduled call is executed.
      */
     void run_one();
 
     /**
-     * @brief Stores tasks to be executed as soon as possible, in sequence.
+     * @brief Executes the first call of `m_scheduled_calls`, its deadline must have expired.
+     */
+    void run_scheduled_call();
+
+    /**
+     * @brief Executes all calls that are due, called when a clock_source that only moves when it is told to was advanced.
+     */
+    void run_due_calls();
+
+    /**
+     * @brief Registers a call, directly in `m_scheduled_calls` on the executor thread, otherwise through `m_registrations`.
+     */
+    scheduled_call register_call(call_t && call);
+
+    /**
+     * @brief Inserts a call into `m_scheduled_calls` on the executor thread, unless it was cancelled already.
+     */
+    void insert_scheduled_call(call_t && call);
+
+    /**
+     * @brief A call that is kept by `m_timer_service`, shared by the service thread and the executor thread.
+     *
+     * Its id in `m_handles` is released when the last of them drops it, whether the service ran the call, reclaimed it
+     * after a cancel() or removed it with the executor.
+     */
+    struct shared_call
+    {
+        shared_call(call_handles & handles, call_t::id_t id, function_t function, bool repeating, missed_tick_policy policy);
+        ~shared_call();
+
+        shared_call(const shared_call &) = delete;
+        shared_call & operator=(const shared_call &) = delete;
+
+        call_handles & m_handles;
+        const call_t::id_t m_id; // in `m_handles`, linked to the id of the call in `m_timer_service`
+        function_t m_function; // executor thread only
+        const bool m_repeating;
+        const missed_tick_policy m_policy;
+
+        // a tick was added as a task and did not run yet, only for missed_tick_policy::skip and coalesce
+        std::atomic<bool> m_queued = {false};
+        std::atomic<std::size_t> m_missed = {0};
+    };
+
+    /**
+     * @brief Registers @p call with `m_timer_service`, the service calls dispatch_shared_call() when it is due.
+     */
+    void register_shared_call(call_t && call);
+
+    /**
+     * @brief On the service thread, adds the due @p call as a task, or cancels it in the service when it was cancelled.
+     */
+    void dispatch_shared_call(const std::shared_ptr<shared_call> & call);
+
+    /**
+     * @brief On the executor thread, runs a tick of @p call that was due at @p due.
+     */
+    void run_shared_call(shared_call & call, time_point_t due);
+
+    /**
+     * @brief Removes all cancelled calls from `m_scheduled_calls` once they make up a large part of it.
+     */
+    void reclaim_cancelled_calls();
+
+    std::unique_ptr<slab_resource> m_arena; // only with executor_options::m_memory_resource, it outlives the members below
+
+    /**
+     * @brief Stores tasks to be executed as soon as possible, in sequence, one queue per priority lane.
      *
-     * The `m_queue` structure manages tasks that should be executed immediately,
+     * The `m_lanes` structure manages tasks that should be executed immediately,
      * ensuring strict adherence to the following guarantees:
-     * - Tasks in `m_queue` are always executed before any scheduled tasks in `m_scheduled_calls`.
-     * - Tasks are executed in the exact order they were added to the queue.
+     * - Tasks in `m_lanes` are always executed before any scheduled tasks in `m_scheduled_calls`.
+     * - Tasks are executed in the exact order they were added to the same lane.
      * - Tasks are executed consecutively (never in parallel), ensuring no race conditions exist between them.
+     *
+     * Producers add tasks lock-free, the executor thread only parks on `m_parker` when all lanes are empty.
      */
-    synchronized_queue<std::function<void()>> m_queue;
+    std::array<mpsc_queue<queued_task>, priority_count> m_lanes;
+    parker m_parker; // not used in the busy-poll and reactor modes
+    std::unique_ptr<reactor> m_reactor; // only in the reactor mode
+    time_point_t m_last_poll;
+
+    // per lane, the number of tasks of higher lanes that were executed while it was waiting, executor thread only
+    std::array<std::size_t, priority_count> m_passed_over = {};
 
     /**
      * @brief Stores tasks along with their scheduled execution times.
@@ -134,18 +434,46 @@ private:
      * be executed before their scheduled time.
      *
      * Scheduled tasks in `m_scheduled_calls` are processed only after all tasks
-     * in the immediate task queue (`m_queue`) have been executed.
+     * in the immediate task queues (`m_lanes`) have been executed.
      *
      * Tasks can have a `repeat_duration`, indicating that they will be rescheduled
      * after completion at the time point `start time + repeat_duration`.
      *
      * If a task's execution exceeds its `repeat_duration`, the next instance will be scheduled in
      * the past, resulting in immediate execution as soon as the system has capacity.
-     * This effectively allows the task to "catch up." (assuming its slow execution was due to temporary lack of resources)
+     * By default this allows the task to "catch up." (assuming its slow execution was due to temporary lack of resources)
+     * A task with missed_tick_policy::skip or missed_tick_policy::coalesce does not run a burst of missed ticks.
      *
      */
     scheduled_calls m_scheduled_calls;
 
+    timer_service * m_timer_service; // keeps the scheduled calls instead of `m_scheduled_calls` when it is set
+    clock_source * m_clock; // null for std::chrono::steady_clock
+
+    /**
+     * @brief The cancellation state of all calls in `m_scheduled_calls` and `m_registrations`, indexed by their id.
+     *
+     * Other threads cancel a call by flipping its state, the executor thread skips and reclaims cancelled calls
+     * when they become due, or earlier in bulk when many calls are cancelled (see reclaim_cancelled_calls()).
+     */
+    call_handles m_handles;
+
+    /**
+     * @brief Calls registered by other threads than the executor thread.
+     *
+     * The executor thread moves them into `m_scheduled_calls` before it looks at the next deadline.
+     */
+    mpsc_queue<call_t> m_registrations;
+
+    executor_counters m_counters;
+
+    // the missed ticks and the lateness of the scheduled call that is running, executor thread only
+    std::size_t m_missed_ticks = 0;
+    duration_t m_lateness = duration_t::zero();
+
+    const bool m_busy_poll;
+    const duration_t m_precision_window;
+
     std::atomic<std::thread::id> m_threadId = {};
 
     bool m_end = false;
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#pragma once
+
+#include "executor/memory_resource.hpp"
+#include "executor/priority.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace venus {
+
+/**
+ * @brief A histogram of durations with power-of-two buckets.
+ *
+ * Bucket 0 counts durations of 0ns (and negative durations), bucket i counts durations in [2^(i-1), 2^i) nanoseconds.
+ */
+struct duration_histogram
+{
+    static constexpr std::size_t bucket_count = 64;
+
+    std::array<std::uint64_t, bucket_count> m_buckets = {};
+
+    [[nodiscard]] std::uint64_t count() const;
+
+    /**
+     * @brief The upper bound of the bucket that contains the @p fraction (0.0 - 1.0) percentile, zero when the histogram is empty.
+     */
+    [[nodiscard]] std::chrono::nanoseconds percentile(double fraction) const;
+
+    [[nodiscard]] static std::size_t bucket(std::chrono::nanoseconds duration);
+    [[nodiscard]] static std::chrono::nanoseconds upper_bound(std::size_t bucket);
+};
+
+/**
+ * @brief A snapshot of the runtime statistics of a venus::executor, see executor::stats().
+ *
+ * The counters are read one by one without stopping the executor, so a snapshot is not an atomic cut:
+ * for example, a histogram can already include a task that m_executed does not count yet.
+ */
+struct executor_stats
+{
+    std::uint64_t m_submitted = 0; // tasks added with add(), add_bulk(), call() and call_async()
+    std::uint64_t m_executed = 0; // tasks taken from the queue and executed
+    std::uint64_t m_queue_depth = 0; // tasks in the queue at the moment of the snapshot, in all lanes
+    std::uint64_t m_peak_queue_depth = 0; // the largest queue depth the executor thread saw, see executor_counters::on_drain()
+    std::array<std::uint64_t, priority_count> m_lane_depth = {}; // the queue depth per lane, indexed by lane_index()
+    std::uint64_t m_scheduled_calls = 0; // calls in m_scheduled_calls, excluding calls still being registered
+    std::uint64_t m_scheduled_calls_executed = 0;
+
+    duration_histogram m_queue_wait; // from add() until the task starts
+    duration_histogram m_task_duration; // the run time of tasks, excluding scheduled calls
+    duration_histogram m_lateness; // from the (coalesced) deadline of a scheduled call until it starts
+
+    memory_stats m_memory; // the arena of the executor, all zero without executor_options::m_memory_resource
+};
+
+/**
+ * @brief The atomic counters behind executor_stats.
+ *
+ * All updates use relaxed atomics. The histograms are only updated by the executor thread, so they use a
+ * plain load and store instead of a read-modify-write. Any thread can take a snapshot().
+ *
+ * The counters that producers write and the ones the executor thread writes are on separate cache lines, so add()
+ * only touches the lane counter it increments.
+ */
+class executor_counters
+{
+public:
+    static constexpr std::size_t drain_interval = 64;
+
+    void on_submit(priority lane, std::uint64_t count);
+
+    /**
+     * @brief Updates the peak queue depth, the executor thread calls it when it starts to drain the queue,
+     * and every `drain_interval` tasks while it keeps draining.
+     */
+    void on_drain();
+    void on_start(priority lane, std::chrono::nanoseconds queue_wait);
+    void on_task_done(std::chrono::nanoseconds duration);
+    void on_scheduled_call(std::chrono::nanoseconds lateness);
+    void set_scheduled_calls(std::size_t count);
+
+    [[nodiscard]] executor_stats snapshot() const;
+
+private:
+    class histogram
+    {
+    public:
+        void record(std::chrono::nanoseconds duration);
+        void copy_to(duration_histogram & snapshot) const;
+
+    private:
+        std::array<std::atomic<std::uint64_t>, duration_histogram::bucket_count> m_buckets = {};
+    };
+
+    static void increment(std::atomic<std::uint64_t> & counter);
+
+    static constexpr std::size_t cache_line_size = 64;
+
+    // written by producers, padded instead of alignas(cache_line_size), operator new does not honour that in C++14
+    std::array<char, cache_line_size> m_padding_before = {};
+    std::array<std::atomic<std::uint64_t>, priority_count> m_submitted = {};
+    std::array<char, cache_line_size> m_padding_after = {};
+
+    // written by the executor thread only
+    std::array<std::atomic<std::uint64_t>, priority_count> m_executed = {};
+    std::atomic<std::uint64_t> m_peak_queue_depth = {0};
+    std::atomic<std::uint64_t> m_scheduled_calls = {0};
+    std::atomic<std::uint64_t> m_scheduled_calls_executed = {0};
+    histogram m_queue_wait;
+    histogram m_task_duration;
+    histogram m_lateness;
+};
+
+} // namespace venus
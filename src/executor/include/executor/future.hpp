@@ -0,0 +1,476 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#pragma once
+
+#include "executor/unique_task.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace venus {
+
+template <typename T>
+class future;
+
+template <typename T>
+class promise;
+
+namespace detail {
+
+// the value stored for a future<void>
+struct unit
+{
+};
+
+template <typename T>
+using stored_t = std::conditional_t<std::is_void<T>::value, unit, T>;
+
+/**
+ * @brief The state shared by a promise and its future.
+ *
+ * There is no mutex: the result and the continuation are each written by one side, then both sides set their bit
+ * in `m_flags` with one atomic fetch_or. The side that sets the second bit runs the continuation, so it runs exactly
+ * once, on the thread that completes the promise or, if the result was already there, on the thread that adds it.
+ */
+template <typename T>
+class shared_state
+{
+public:
+    using value_t = stored_t<T>;
+
+    shared_state() = default;
+    shared_state(const shared_state &) = delete;
+    shared_state & operator=(const shared_state &) = delete;
+
+    ~shared_state()
+    {
+        if (m_has_value)
+        {
+            value().~value_t();
+        }
+    }
+
+    void set_value(value_t && value)
+    {
+        ::new (&m_storage) value_t(std::move(value));
+        m_has_value = true;
+        publish(has_result);
+    }
+
+    void set_exception(std::exception_ptr exception)
+    {
+        m_exception = std::move(exception);
+        publish(has_result);
+    }
+
+    void set_continuation(unique_task continuation)
+    {
+        m_continuation = std::move(continuation);
+        publish(has_continuation);
+    }
+
+    [[nodiscard]] bool ready() const
+    {
+        return (m_flags.load(std::memory_order_acquire) & has_result) != 0;
+    }
+
+    /**
+     * @brief Moves the value out, or rethrows the exception, only valid once ready() is `true`.
+     */
+    value_t take()
+    {
+        if (m_exception)
+        {
+            std::rethrow_exception(m_exception);
+        }
+        return std::move(value());
+    }
+
+private:
+    static constexpr std::uint8_t has_result = 1;
+    static constexpr std::uint8_t has_continuation = 2;
+
+    value_t & value()
+    {
+        return *static_cast<value_t *>(static_cast<void *>(&m_storage));
+    }
+
+    void publish(std::uint8_t flag)
+    {
+        if ((m_flags.fetch_or(flag, std::memory_order_acq_rel) | flag) == (has_result | has_continuation))
+        {
+            // the continuation can hold the last reference to this state, do not touch any member after running it
+            auto continuation = std::move(m_continuation);
+            continuation();
+        }
+    }
+
+    std::atomic<std::uint8_t> m_flags = {0};
+    bool m_has_value = false;
+    std::aligned_storage_t<sizeof(value_t), alignof(value_t)> m_storage;
+    std::exception_ptr m_exception;
+    unique_task m_continuation;
+};
+
+// calls fn with the value of a future<T>, or without arguments for a future<void>
+template <typename T>
+struct invoke_with_value
+{
+    template <typename Fn>
+    static decltype(auto) apply(Fn & fn, T && value)
+    {
+        return fn(std::move(value));
+    }
+};
+
+template <>
+struct invoke_with_value<void>
+{
+    template <typename Fn>
+    static decltype(auto) apply(Fn & fn, unit &&)
+    {
+        return fn();
+    }
+};
+
+template <typename T, typename Fn>
+using continuation_result_t = decltype(invoke_with_value<T>::apply(std::declval<Fn &>(), std::declval<stored_t<T>>()));
+
+// completes @p target, a promise<R>, with the result of @p call or with the exception it throws
+template <typename R>
+struct fulfill
+{
+    template <typename Promise, typename Call>
+    static void apply(Promise & target, Call && call)
+    {
+        try
+        {
+            target.set_value(call());
+        }
+        catch (...)
+        {
+            target.set_exception(std::current_exception());
+        }
+    }
+};
+
+template <>
+struct fulfill<void>
+{
+    template <typename Promise, typename Call>
+    static void apply(Promise & target, Call && call)
+    {
+        try
+        {
+            call();
+            target.set_value();
+        }
+        catch (...)
+        {
+            target.set_exception(std::current_exception());
+        }
+    }
+};
+
+// the continuation used by via(), it passes the value on unchanged
+template <typename T>
+struct forward_value
+{
+    T operator()(T && value) const
+    {
+        return std::move(value);
+    }
+};
+
+template <>
+struct forward_value<void>
+{
+    void operator()() const
+    {
+    }
+};
+
+} // namespace detail
+
+/**
+ * @brief The producing side of a venus::future, like std::promise.
+ *
+ * A promise that is destroyed without being satisfied completes its future with a std::future_error(broken_promise).
+ */
+template <typename T>
+class promise
+{
+public:
+    using value_t = detail::stored_t<T>;
+
+    promise() :
+        m_state(std::make_shared<detail::shared_state<T>>())
+    {
+    }
+
+    promise(promise &&) noexcept = default;
+    promise(const promise &) = delete;
+    promise & operator=(const promise &) = delete;
+
+    promise & operator=(promise && other) noexcept
+    {
+        if (this != &other)
+        {
+            abandon();
+            m_state = std::move(other.m_state);
+            m_retrieved = other.m_retrieved;
+            m_satisfied = other.m_satisfied;
+        }
+        return *this;
+    }
+
+    ~promise()
+    {
+        abandon();
+    }
+
+    /**
+     * @throws std::future_error when the future was already retrieved.
+     */
+    future<T> get_future()
+    {
+        if (m_retrieved)
+        {
+            throw std::future_error(std::future_errc::future_already_retrieved);
+        }
+        m_retrieved = true;
+        return future<T>(state());
+    }
+
+    /**
+     * @brief Stores @p value and runs the continuation of the future, if one was added already, on this thread.
+     *
+     * @throws std::future_error when the promise was already satisfied.
+     */
+    void set_value(value_t value)
+    {
+        satisfy();
+        m_state->set_value(std::move(value));
+    }
+
+    // for promise<void>
+    void set_value()
+    {
+        set_value(detail::unit{});
+    }
+
+    void set_exception(std::exception_ptr exception)
+    {
+        satisfy();
+        m_state->set_exception(std::move(exception));
+    }
+
+private:
+    std::shared_ptr<detail::shared_state<T>> state() const
+    {
+        if (!m_state)
+        {
+            throw std::future_error(std::future_errc::no_state);
+        }
+        return m_state;
+    }
+
+    void satisfy()
+    {
+        state();
+        if (m_satisfied)
+        {
+            throw std::future_error(std::future_errc::promise_already_satisfied);
+        }
+        m_satisfied = true;
+    }
+
+    void abandon()
+    {
+        if (m_state && !m_satisfied)
+        {
+            m_satisfied = true;
+            m_state->set_exception(std::make_exception_ptr(std::future_error(std::future_errc::broken_promise)));
+        }
+    }
+
+    std::shared_ptr<detail::shared_state<T>> m_state;
+    bool m_retrieved = false;
+    bool m_satisfied = false;
+};
+
+/**
+ * @brief A move-only future with non-blocking continuations.
+ *
+ * Unlike std::future, a continuation added with then() runs when the value becomes available, so no thread
+ * waits for it. The shared state has no mutex, completing a promise and adding a continuation each cost
+ * one atomic read-modify-write.
+ *
+ * then() and via() consume the future, a future has at most one continuation. An exception propagates along
+ * the chain, continuations after the stage that threw are skipped and get() rethrows it.
+ *
+ * Example, the "executor -> pool work -> back to executor" pattern without blocking any thread:
+ *
+ *     venus::async(pool, [data] { return crunch(data); })
+ *         .then(executor, [this](result r) { m_result = r; });
+ */
+template <typename T>
+class future
+{
+public:
+    future() = default;
+
+    [[nodiscard]] bool valid() const
+    {
+        return m_state != nullptr;
+    }
+
+    /**
+     * @brief Checks whether the value or exception is available, get() does not block when this is `true`.
+     */
+    [[nodiscard]] bool ready() const
+    {
+        return m_state != nullptr && m_state->ready();
+    }
+
+    /**
+     * @brief Waits for the value and returns it, or rethrows the exception; the future is no longer valid() afterwards.
+     */
+    T get()
+    {
+        auto state = take_state();
+        if (!state->ready())
+        {
+            wait(*state);
+        }
+        // static_cast<void> turns the detail::unit of a future<void> into 'return void'
+        return static_cast<T>(state->take());
+    }
+
+    /**
+     * @brief Runs @p fn with the value when it becomes available, on the thread that completes the promise,
+     * or right away on this thread if the value is available already.
+     *
+     * @return a future for the result of @p fn.
+     */
+    template <typename Fn>
+    auto then(Fn fn) -> future<detail::continuation_result_t<T, Fn>>
+    {
+        using result_t = detail::continuation_result_t<T, Fn>;
+        promise<result_t> next;
+        auto result = next.get_future();
+        auto state = take_state();
+        auto & continued = *state;
+        continued.set_continuation([state = std::move(state), next = std::move(next), fn = std::move(fn)]() mutable {
+            run(*state, next, fn);
+        });
+        return result;
+    }
+
+    /**
+     * @brief Runs @p fn with the value on @p executor, when the value becomes available.
+     *
+     * @p executor can be any type with an add(venus::function_t) method, like venus::executor and venus::pool_executor,
+     * it must outlive the completion of this future.
+     *
+     * @return a future for the result of @p fn.
+     */
+    template <typename Executor, typename Fn>
+    auto then(Executor & executor, Fn fn) -> future<detail::continuation_result_t<T, Fn>>
+    {
+        using result_t = detail::continuation_result_t<T, Fn>;
+        promise<result_t> next;
+        auto result = next.get_future();
+        auto state = take_state();
+        auto & continued = *state;
+        continued.set_continuation([&executor, state = std::move(state), next = std::move(next), fn = std::move(fn)]() mutable {
+            executor.add([state = std::move(state), next = std::move(next), fn = std::move(fn)]() mutable {
+                run(*state, next, fn);
+            });
+        });
+        return result;
+    }
+
+    /**
+     * @brief Moves the completion to @p executor, continuations added with then(fn) to the returned future run there.
+     */
+    template <typename Executor>
+    future via(Executor & executor)
+    {
+        return then(executor, detail::forward_value<T>());
+    }
+
+private:
+    template <typename U>
+    friend class promise;
+
+    explicit future(std::shared_ptr<detail::shared_state<T>> state) :
+        m_state(std::move(state))
+    {
+    }
+
+    std::shared_ptr<detail::shared_state<T>> take_state()
+    {
+        if (!m_state)
+        {
+            throw std::future_error(std::future_errc::no_state);
+        }
+        return std::move(m_state);
+    }
+
+    template <typename R, typename Fn>
+    static void run(detail::shared_state<T> & state, promise<R> & next, Fn & fn)
+    {
+        detail::fulfill<R>::apply(next, [&]() -> R { return detail::invoke_with_value<T>::apply(fn, state.take()); });
+    }
+
+    // blocks until the state is ready, the only place a mutex is used, it lives on the stack of the waiting thread.
+    static void wait(detail::shared_state<T> & state)
+    {
+        struct waiter
+        {
+            std::mutex m_mutex;
+            std::condition_variable m_condition;
+            bool m_done = false;
+        } waiter;
+
+        state.set_continuation([&waiter] {
+            // notify while holding the lock, the waiter can destroy itself as soon as it is released
+            std::lock_guard<std::mutex> lock(waiter.m_mutex);
+            waiter.m_done = true;
+            waiter.m_condition.notify_one();
+        });
+
+        std::unique_lock<std::mutex> lock(waiter.m_mutex);
+        waiter.m_condition.wait(lock, [&waiter] { return waiter.m_done; });
+    }
+
+    std::shared_ptr<detail::shared_state<T>> m_state;
+};
+
+/**
+ * @brief Runs @p fn on @p executor and returns a venus::future for its result.
+ *
+ * @p executor can be any type with an add(venus::function_t) method, like venus::executor and venus::pool_executor.
+ */
+template <typename Executor, typename Fn>
+auto async(Executor & executor, Fn fn) -> future<decltype(fn())>
+{
+    using result_t = decltype(fn());
+    promise<result_t> started;
+    auto result = started.get_future();
+    executor.add([started = std::move(started), fn = std::move(fn)]() mutable { detail::fulfill<result_t>::apply(started, fn); });
+    return result;
+}
+
+} // namespace venus
@@ -4,29 +4,279 @@
 
 #pragma once
 
+#include "executor/spin_wait.hpp"
+
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
 #include <mutex>
 #include <queue>
+#include <shared_mutex>
+#include <type_traits>
+#include <utility>
 
 namespace venus {
 
-// template <typename T>
-// class guarded
-// {
-// private:
-//     T m_data;
-//     std::mutex m_mutex;
-
-// public:
-//     template <typename Func>
-//     auto with_lock(Func && func)
-//     {
-//         std::lock_guard<std::mutex> lock(m_mutex);
-//         return func(m_data);
-//     }
-// };
+/**
+ * @brief Data protected by a reader-writer lock, for state that is read far more often than it is written.
+ *
+ * Readers hold a shared lock, so any number of them run at the same time, a writer holds the lock exclusively.
+ * The readers still write to the lock's shared counter, so with many readers on many cores that cache line moves
+ * between the cores, see venus::guarded_snapshot and venus::guarded_seqlock for readers that do not write at all.
+ */
+template <typename T>
+class guarded
+{
+private:
+    T m_data;
+    mutable std::shared_timed_mutex m_mutex;
+
+public:
+    guarded() = default;
+
+    explicit guarded(T data) :
+        m_data(std::move(data))
+    {
+    }
+
+    /**
+     * @brief Executes @p action with a `const T &`, while holding the lock shared with other readers.
+     *
+     * @return The result of invoking @p action
+     */
+    template <typename Action>
+    auto with_shared_lock(Action && action) const
+    {
+        std::shared_lock<std::shared_timed_mutex> lock(m_mutex);
+        return action(static_cast<const T &>(m_data));
+    }
 
+    /**
+     * @brief Executes @p action with a `T &`, while holding the lock exclusively.
+     *
+     * @return The result of invoking @p action
+     */
+    template <typename Action>
+    auto with_unique_lock(Action && action)
+    {
+        std::lock_guard<std::shared_timed_mutex> lock(m_mutex);
+        return action(m_data);
+    }
+
+    /**
+     * @brief Same as with_unique_lock(), for symmetry with venus::guarded_notify.
+     */
+    template <typename Action>
+    auto with_lock(Action && action)
+    {
+        return with_unique_lock(std::forward<Action>(action));
+    }
+};
+
+/**
+ * @brief Immutable snapshots of the data, a reader takes a `std::shared_ptr<const T>` and keeps it as long as it likes.
+ *
+ * A writer copies the current snapshot, changes the copy and publishes it, readers that hold an older snapshot keep
+ * using it until they release it (read-copy-update). Readers never wait for a writer, and the writer never waits for
+ * the readers, only writers wait for each other. This fits configuration and routing tables that are replaced
+ * occasionally as a whole and read by every thread.
+ */
+template <typename T>
+class guarded_snapshot
+{
+private:
+#if defined(__cpp_lib_atomic_shared_ptr)
+    std::atomic<std::shared_ptr<const T>> m_current;
+
+    std::shared_ptr<const T> load() const
+    {
+        return m_current.load();
+    }
+
+    void publish(std::shared_ptr<const T> data)
+    {
+        m_current.store(std::move(data));
+    }
+#else
+    std::shared_ptr<const T> m_current;
+
+    std::shared_ptr<const T> load() const
+    {
+        return std::atomic_load(&m_current);
+    }
+
+    void publish(std::shared_ptr<const T> data)
+    {
+        std::atomic_store(&m_current, std::move(data));
+    }
+#endif
+    std::mutex m_writer_mutex;
+
+public:
+    guarded_snapshot() :
+        guarded_snapshot(T())
+    {
+    }
+
+    explicit guarded_snapshot(T data) :
+        m_current(std::make_shared<const T>(std::move(data)))
+    {
+    }
+
+    /**
+     * @brief The current data, it does not change anymore, also not when a writer publishes a new snapshot.
+     */
+    std::shared_ptr<const T> snapshot() const
+    {
+        return load();
+    }
+
+    /**
+     * @brief Replaces the data with @p data.
+     */
+    void store(T data)
+    {
+        std::lock_guard<std::mutex> lock(m_writer_mutex);
+        publish(std::make_shared<const T>(std::move(data)));
+    }
+
+    /**
+     * @brief Executes @p action with a `T &` to a copy of the current data, then publishes the copy.
+     *
+     * Concurrent updates are serialized, so none of them is lost.
+     */
+    template <typename Action>
+    void update(Action && action)
+    {
+        std::lock_guard<std::mutex> lock(m_writer_mutex);
+        auto copy = std::make_shared<T>(*load());
+        action(*copy);
+        publish(std::move(copy));
+    }
+};
+
+/**
+ * @brief Data behind a sequence lock, readers copy it without writing to any shared memory, for small trivially copyable @p T.
+ *
+ * A writer makes the sequence number odd, writes the data and makes it even again. A reader copies the data between
+ * two reads of the sequence number and retries when a writer was active in between. Readers never block a writer and
+ * scale with the number of cores, a reader only retries while a write is in progress. The data is stored as atomic
+ * words, so the copy that a reader throws away is not a data race, on x86 these are plain loads and stores.
+ */
+template <typename T>
+class guarded_seqlock
+{
+    static_assert(std::is_trivially_copyable<T>::value, "guarded_seqlock needs a trivially copyable type, use guarded_snapshot instead");
+
+private:
+    static constexpr std::size_t word_count = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+    std::atomic<std::uint64_t> m_sequence = {0};
+    std::array<std::atomic<std::uint64_t>, word_count> m_words;
+    std::mutex m_writer_mutex;
+
+    void write(const T & data)
+    {
+        std::array<std::uint64_t, word_count> words = {};
+        std::memcpy(words.data(), &data, sizeof(T));
+
+        // the release stores of the words keep the odd sequence number before them, a reader that sees a new word
+        // also sees the odd sequence number when it checks it again.
+        auto sequence = m_sequence.load(std::memory_order_relaxed);
+        m_sequence.store(sequence + 1, std::memory_order_relaxed);
+        for (std::size_t i = 0; i < word_count; ++i)
+        {
+            m_words[i].store(words[i], std::memory_order_release);
+        }
+        m_sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    T read_unlocked() const
+    {
+        std::array<std::uint64_t, word_count> words;
+        for (std::size_t i = 0; i < word_count; ++i)
+        {
+            words[i] = m_words[i].load(std::memory_order_relaxed);
+        }
+        T data;
+        std::memcpy(static_cast<void *>(&data), words.data(), sizeof(T));
+        return data;
+    }
+
+public:
+    guarded_seqlock() :
+        guarded_seqlock(T())
+    {
+    }
+
+    explicit guarded_seqlock(const T & data)
+    {
+        for (auto & word : m_words)
+        {
+            word.store(0, std::memory_order_relaxed);
+        }
+        write(data);
+    }
+
+    /**
+     * @brief A consistent copy of the data, this spins while a write is in progress.
+     */
+    T load() const
+    {
+        std::array<std::uint64_t, word_count> words;
+        for (;;)
+        {
+            auto before = m_sequence.load(std::memory_order_acquire);
+            if ((before & 1) == 0)
+            {
+                // acquire loads, so the second read of the sequence number cannot move before them
+                for (std::size_t i = 0; i < word_count; ++i)
+                {
+                    words[i] = m_words[i].load(std::memory_order_acquire);
+                }
+                if (m_sequence.load(std::memory_order_relaxed) == before)
+                {
+                    break;
+                }
+            }
+            cpu_relax();
+        }
+
+        T data;
+        std::memcpy(static_cast<void *>(&data), words.data(), sizeof(T));
+        return data;
+    }
+
+    void store(const T & data)
+    {
+        std::lock_guard<std::mutex> lock(m_writer_mutex);
+        write(data);
+    }
+
+    /**
+     * @brief Executes @p action with a `T &` to a copy of the data and stores the result, concurrent updates are serialized.
+     */
+    template <typename Action>
+    void update(Action && action)
+    {
+        std::lock_guard<std::mutex> lock(m_writer_mutex);
+        auto data = read_unlocked(); // no other writer can be active
+        action(data);
+        write(data);
+    }
+};
+
+/**
+ * @brief Data protected by a mutex, with a condition variable to wait for changes to it.
+ *
+ * Threads that wait first spin for a short time (see venus::spin_policy), only then they sleep on the condition
+ * variable. The sleeping threads are counted, so notifying costs nothing when nobody sleeps.
+ */
 template <typename T>
 class guarded_notify
 {
@@ -34,8 +284,76 @@ private:
     T m_data;
     std::mutex m_mutex;
     std::condition_variable m_condition;
+    std::size_t m_waiters = 0; // threads sleeping on m_condition, protected by m_mutex
+    std::atomic<std::uint64_t> m_version = {0}; // incremented on every notify, spinning threads watch it without the lock
+    spin_policy m_spin;
+
+    template <typename Condition>
+    bool spin(std::unique_lock<std::mutex> & lock, Condition & condition)
+    {
+        auto version = m_version.load(std::memory_order_relaxed);
+        lock.unlock();
+        spin_until(m_spin, [&] { return m_version.load(std::memory_order_acquire) != version; });
+        lock.lock();
+        return condition(m_data);
+    }
+
+    template <typename Condition>
+    void wait(std::unique_lock<std::mutex> & lock, Condition & condition)
+    {
+        if (condition(m_data) || spin(lock, condition))
+        {
+            return;
+        }
+
+        ++m_waiters;
+        m_condition.wait(lock, [&]() { return condition(m_data); });
+        --m_waiters;
+    }
+
+    template <typename Condition, typename Timepoint>
+    bool wait_until(std::unique_lock<std::mutex> & lock, Condition & condition, const Timepoint & timepoint)
+    {
+        if (condition(m_data) || spin(lock, condition))
+        {
+            return true;
+        }
+
+        ++m_waiters;
+        auto result = m_condition.wait_until(lock, timepoint, [&]() { return condition(m_data); });
+        --m_waiters;
+        return result;
+    }
+
+    // unlocks and notifies, the notify is skipped when no thread sleeps
+    void unlock_and_notify(std::unique_lock<std::mutex> & lock, bool all)
+    {
+        m_version.store(m_version.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        auto waiting = m_waiters != 0;
+        lock.unlock();
+        if (!waiting)
+        {
+            return;
+        }
+
+        if (all)
+        {
+            m_condition.notify_all();
+        }
+        else
+        {
+            m_condition.notify_one();
+        }
+    }
 
 public:
+    guarded_notify() = default;
+
+    explicit guarded_notify(spin_policy spin) :
+        m_spin(spin)
+    {
+    }
+
     /**
      * @brief Executes the provided @p action while holding the lock.
      *
@@ -64,7 +382,7 @@ public:
     void wait_for(Condition && condition)
     {
         std::unique_lock<std::mutex> lock(m_mutex);
-        m_condition.wait(lock, [&]() { return condition(m_data); });
+        wait(lock, condition);
     }
 
     /**
@@ -80,7 +398,7 @@ public:
     auto wait_for(Condition && condition, Timepoint timepoint)
     {
         std::unique_lock<std::mutex> lock(m_mutex);
-        return m_condition.wait_until(lock, timepoint, [&]() { return condition(m_data); });
+        return wait_until(lock, condition, timepoint);
     }
 
     /**
@@ -90,11 +408,61 @@ public:
     void with_lock_and_notify(Condition && condition, Action && action)
     {
         std::unique_lock<std::mutex> lock(m_mutex);
-        m_condition.wait(lock, [&]() { return condition(m_data); });
+        wait(lock, condition);
 
         action(m_data);
-        lock.unlock();
-        m_condition.notify_one();
+        unlock_and_notify(lock, false);
+    }
+
+    /**
+     * @brief executes @p action if @p condition becomes true before the @p timepoint is reached
+     * @return `true` if @p action was executed; `false` if the @p timepoint was reached first.
+     */
+    template <typename Condition, typename Action, typename Timepoint>
+    bool with_lock_and_notify_until(Condition && condition, Action && action, const Timepoint & timepoint)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!wait_until(lock, condition, timepoint))
+        {
+            return false;
+        }
+
+        action(m_data);
+        unlock_and_notify(lock, false);
+        return true;
+    }
+
+    /**
+     * @brief executes @p action only if @p condition is true right away, this never waits for the condition
+     * @return `true` if @p action was executed; `false` otherwise.
+     */
+    template <typename Condition, typename Action>
+    bool try_with_lock_and_notify(Condition && condition, Action && action)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!condition(m_data))
+        {
+            return false;
+        }
+
+        action(m_data);
+        unlock_and_notify(lock, false);
+        return true;
+    }
+
+    /**
+     * @brief executes @p action after waiting for @p condition and wakes up all waiting threads
+     *
+     * Use this when @p action changes the state for more than one waiter, like adding or removing a batch of items.
+     */
+    template <typename Condition, typename Action>
+    void with_lock_and_notify_all(Condition && condition, Action && action)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        wait(lock, condition);
+
+        action(m_data);
+        unlock_and_notify(lock, true);
     }
 
     /**
@@ -105,11 +473,25 @@ public:
     auto with_lock_and_notify_r(Condition && condition, Action && action)
     {
         std::unique_lock<std::mutex> lock(m_mutex);
-        m_condition.wait(lock, [&]() { return condition(m_data); });
+        wait(lock, condition);
 
         auto result = action(m_data);
-        lock.unlock();
-        m_condition.notify_one();
+        unlock_and_notify(lock, false);
+        return result;
+    }
+
+    /**
+     * @brief executes @p action after waiting for @p condition and wakes up all waiting threads, where @p action returns a result
+     * @return the result of action()
+     */
+    template <typename Condition, typename Action>
+    auto with_lock_and_notify_all_r(Condition && condition, Action && action)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        wait(lock, condition);
+
+        auto result = action(m_data);
+        unlock_and_notify(lock, true);
         return result;
     }
 };
@@ -0,0 +1,295 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace venus {
+
+/**
+ * @brief An interface for memory allocation, like std::pmr::memory_resource, which is not available in C++14.
+ */
+class memory_resource
+{
+public:
+    virtual ~memory_resource() = default;
+
+    /**
+     * @throws std::bad_alloc when the memory cannot be allocated.
+     */
+    void * allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t))
+    {
+        return do_allocate(bytes, alignment);
+    }
+
+    /**
+     * @brief Returns the memory of an allocate() call with the same @p bytes and @p alignment.
+     */
+    void deallocate(void * p, std::size_t bytes, std::size_t alignment = alignof(std::max_align_t))
+    {
+        do_deallocate(p, bytes, alignment);
+    }
+
+    [[nodiscard]] bool is_equal(const memory_resource & other) const noexcept
+    {
+        return do_is_equal(other);
+    }
+
+private:
+    virtual void * do_allocate(std::size_t bytes, std::size_t alignment) = 0;
+    virtual void do_deallocate(void * p, std::size_t bytes, std::size_t alignment) = 0;
+    virtual bool do_is_equal(const memory_resource & other) const noexcept = 0;
+};
+
+inline bool operator==(const memory_resource & a, const memory_resource & b) noexcept
+{
+    return &a == &b || a.is_equal(b);
+}
+
+inline bool operator!=(const memory_resource & a, const memory_resource & b) noexcept
+{
+    return !(a == b);
+}
+
+/**
+ * @brief The memory_resource that uses the global operator new and delete.
+ */
+memory_resource * new_delete_resource() noexcept;
+
+/**
+ * @brief An allocator that allocates from a memory_resource, like std::pmr::polymorphic_allocator.
+ *
+ * A null resource is the new_delete_resource(). Containers keep the resource they were constructed with,
+ * it is not propagated on assignment, so the resource must outlive the container.
+ */
+template <typename T>
+class polymorphic_allocator
+{
+public:
+    using value_type = T;
+
+    polymorphic_allocator() noexcept :
+        m_resource(new_delete_resource())
+    {
+    }
+
+    polymorphic_allocator(memory_resource * resource) noexcept : // implicit, like std::pmr::polymorphic_allocator
+        m_resource(resource != nullptr ? resource : new_delete_resource())
+    {
+    }
+
+    template <typename U>
+    polymorphic_allocator(const polymorphic_allocator<U> & other) noexcept :
+        m_resource(other.resource())
+    {
+    }
+
+    T * allocate(std::size_t n)
+    {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T))
+        {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T *>(m_resource->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T * p, std::size_t n) noexcept
+    {
+        m_resource->deallocate(p, n * sizeof(T), alignof(T));
+    }
+
+    [[nodiscard]] memory_resource * resource() const noexcept
+    {
+        return m_resource;
+    }
+
+private:
+    memory_resource * m_resource;
+};
+
+template <typename T, typename U>
+bool operator==(const polymorphic_allocator<T> & a, const polymorphic_allocator<U> & b) noexcept
+{
+    return *a.resource() == *b.resource();
+}
+
+template <typename T, typename U>
+bool operator!=(const polymorphic_allocator<T> & a, const polymorphic_allocator<U> & b) noexcept
+{
+    return !(a == b);
+}
+
+/**
+ * @brief The allocation counters of a venus::slab_resource, see slab_resource::stats().
+ */
+struct memory_stats
+{
+    std::uint64_t m_allocations = 0; // allocate() calls
+    std::uint64_t m_deallocations = 0; // deallocate() calls
+    std::uint64_t m_bytes_in_use = 0; // bytes allocated and not deallocated yet, as requested by the callers
+    std::uint64_t m_upstream_allocations = 0; // slabs and large blocks that were allocated from the upstream resource
+    std::uint64_t m_upstream_bytes = 0; // the memory held from the upstream resource at the moment of the snapshot
+};
+
+/**
+ * @brief A recycling memory_resource for the small, short-lived objects of an executor: queue nodes, task closures
+ * and scheduled call entries.
+ *
+ * Requests up to `max_block_size` bytes are rounded up to a power-of-two size class, each size class carves its blocks
+ * from slabs of `slab_size` bytes and recycles the deallocated blocks, so once the working set is reached
+ * allocate() and deallocate() do not call the upstream resource anymore: m_upstream_allocations stays the same.
+ * Larger requests and over-aligned requests go straight to the upstream resource.
+ *
+ * Every thread that uses the resource gets a cache of free blocks and its own counters, so allocate() and deallocate()
+ * take no lock and do no atomic read-modify-write. Blocks move between the caches in batches of `batch_size`,
+ * through a lock-free stack per size class, like the free slots of venus::call_handles: the producers that allocate
+ * queue nodes take batches, the executor thread that deallocates them gives batches back, and they never wait for each other.
+ * A thread cache links its blocks through their first bytes, the stacks link the batches in the header of the slab,
+ * so a thread that reads a stale head never reads a block that is in use. A slab is aligned to `slab_size`,
+ * so deallocate() finds the slab of a block from its address.
+ *
+ * The cache of a thread is returned to the resource when the thread ends. The memory is returned to the upstream
+ * resource when the slab_resource is destroyed, a burst of allocations keeps its slabs until then.
+ * All methods can be called from any thread.
+ */
+class slab_resource : public memory_resource
+{
+public:
+    static constexpr std::size_t min_block_size = 16;
+    static constexpr std::size_t size_class_count = 7; // 16, 32, ... 1024 bytes
+    static constexpr std::size_t max_block_size = min_block_size << (size_class_count - 1);
+    static constexpr std::size_t slab_size = 64 * 1024;
+    static constexpr std::size_t slab_chunk_size = 1024;
+    static constexpr std::size_t max_slab_chunks = 1024; // at most 64GB of slabs
+    static constexpr std::uint32_t batch_size = 32; // a thread cache keeps less than two batches of deallocated blocks
+
+    explicit slab_resource(memory_resource * upstream = new_delete_resource());
+    ~slab_resource() override;
+
+    slab_resource(const slab_resource &) = delete;
+    slab_resource & operator=(const slab_resource &) = delete;
+
+    [[nodiscard]] memory_resource * upstream() const;
+
+    /**
+     * @brief Takes a snapshot of the counters of all threads, they are read one by one, so it is not an atomic cut.
+     */
+    [[nodiscard]] memory_stats stats() const;
+
+    /**
+     * @brief The number of blocks of @p block_size bytes in one slab, the rest holds the header and the free list links.
+     */
+    [[nodiscard]] static std::size_t blocks_per_slab(std::size_t block_size);
+
+private:
+    void * do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void * p, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const memory_resource & other) const noexcept override;
+
+    using link_t = std::atomic<std::uint32_t>; // block id + 1 of the first block of the next batch on a shared stack
+
+    // the header of every slab, followed by one link per block and then the blocks
+    struct slab
+    {
+        std::uint32_t m_number; // the index in m_slab_chunks, the high bits of the ids of its blocks
+    };
+
+    struct size_class
+    {
+        std::size_t m_block_size = 0;
+        std::size_t m_block_shift = 0; // log2 of m_block_size
+        std::size_t m_first_block = 0; // the offset of the first block in a slab
+        std::uint32_t m_blocks = 0; // per slab
+
+        // lock-free stacks of free blocks: (tag << 32) | (block id + 1) of the first block, the tag prevents ABA
+        // m_batches holds batches of batch_size blocks, m_singles the blocks that were left over when a thread cache was removed
+        std::atomic<std::uint64_t> m_batches = {0};
+        std::atomic<std::uint64_t> m_singles = {0};
+        std::atomic<std::uint64_t> m_slab_count = {0};
+    };
+
+    // written by one thread only, or under a mutex, stats() reads them from another thread
+    struct class_counters
+    {
+        std::atomic<std::uint64_t> m_allocations = {0};
+        std::atomic<std::uint64_t> m_allocated_bytes = {0};
+        std::atomic<std::uint64_t> m_deallocations = {0};
+        std::atomic<std::uint64_t> m_deallocated_bytes = {0};
+    };
+
+    // free blocks that are linked through their first bytes, only the first m_count blocks belong to the chain
+    struct local_blocks
+    {
+        void * m_head = nullptr;
+        std::uint32_t m_count = 0;
+    };
+
+    // the free blocks and counters of one thread
+    struct thread_cache
+    {
+        std::atomic<slab_resource *> m_owner = {nullptr}; // null once the resource is destroyed
+        std::array<local_blocks, size_class_count> m_blocks;
+        std::array<class_counters, size_class_count> m_counters;
+    };
+
+    // the caches of the calling thread, one per slab_resource it used, see local_cache()
+    struct thread_caches;
+
+    struct large_blocks
+    {
+        std::atomic<std::uint64_t> m_allocations = {0};
+        std::atomic<std::uint64_t> m_deallocations = {0};
+        std::atomic<std::uint64_t> m_bytes_in_use = {0};
+    };
+
+    // the size class of a block of @p bytes, size_class_count when it is too large
+    static std::size_t class_index(std::size_t bytes);
+    static link_t * links(slab * s);
+    static slab * slab_of(void * block);
+    static char * block_address(const size_class & c, slab * s, std::uint32_t block);
+    static std::uint32_t block_index(const size_class & c, slab * s, void * block);
+
+    // the cache of the calling thread, nullptr when its thread_local storage is already destroyed
+    thread_cache * local_cache();
+    thread_cache * find_cache();
+    void remove_cache(thread_cache & cache);
+
+    void * allocate_block(std::size_t index, thread_cache & cache, std::size_t bytes);
+    void deallocate_block(std::size_t index, thread_cache & cache, void * p, std::size_t bytes);
+
+    slab * find_slab(std::uint32_t number) const;
+    void add_slab(slab * s);
+    void allocate_slab(size_class & c, local_blocks & local);
+    bool pop_blocks(const size_class & c, std::atomic<std::uint64_t> & stack, local_blocks & local, std::uint32_t count);
+    void push_blocks(const size_class & c, std::atomic<std::uint64_t> & stack, local_blocks & local, std::uint32_t count);
+    static void push_linked(std::atomic<std::uint64_t> & stack, std::uint32_t first_id, link_t & last_link);
+
+    memory_resource * m_upstream;
+    std::array<size_class, size_class_count> m_classes;
+
+    // slabs by number, in chunks of slab_chunk_size that are created when they are needed and never move
+    std::array<std::atomic<std::atomic<slab *> *>, max_slab_chunks> m_slab_chunks;
+    std::atomic<std::uint32_t> m_slab_numbers = {0};
+
+    // under the cache mutex that all slab_resources share: the registered thread caches and the counters of the removed ones
+    std::vector<thread_cache *> m_caches;
+    std::array<class_counters, size_class_count> m_removed;
+
+    // used by the threads that have no thread_local storage anymore, or could not allocate a cache
+    std::mutex m_shared_mutex;
+    thread_cache m_shared_cache;
+
+    // requests that go straight to the upstream resource
+    large_blocks m_large;
+};
+
+} // namespace venus
@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#pragma once
+
+#include "executor/memory_resource.hpp"
+
+#include <atomic>
+#include <new>
+#include <utility>
+
+namespace venus {
+
+/**
+ * @brief Lock-free, unbounded, multi-producer/single-consumer FIFO queue.
+ *
+ * This is the intrusive node based queue by Dmitry Vyukov: every push() allocates one node that
+ * holds both the value and the link to the next node. A producer claims its place in the queue with a
+ * single atomic exchange, so producers never wait for each other or for the consumer.
+ *
+ * The order in which the exchanges take place is the order in which values are popped.
+ *
+ * The nodes are allocated from the memory_resource given to the constructor, or with the global operator new
+ * when it is null. The resource must be safe to use from all producer threads, like venus::slab_resource.
+ *
+ * @note try_pop() and empty() may only be called from the single consumer thread.
+ * @note A producer that was preempted between its exchange and linking its node makes the queue
+ *       briefly look 'not empty' while try_pop() cannot return a value yet, see empty().
+ */
+template <typename T>
+class mpsc_queue
+{
+private:
+    struct node
+    {
+        node() = default;
+
+        explicit node(T && value) :
+            m_value(std::move(value))
+        {
+        }
+
+        std::atomic<node *> m_next = {nullptr};
+        T m_value;
+    };
+
+    memory_resource * m_resource; // null for the global operator new
+    std::atomic<node *> m_head; // the most recently pushed node, written by producers
+    node * m_tail; // the node before the next value to pop, owned by the consumer
+
+    template <typename... Args>
+    node * create_node(Args &&... args)
+    {
+        if (m_resource == nullptr)
+        {
+            return new node(std::forward<Args>(args)...);
+        }
+
+        auto memory = m_resource->allocate(sizeof(node), alignof(node));
+        try
+        {
+            return ::new (memory) node(std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            m_resource->deallocate(memory, sizeof(node), alignof(node));
+            throw;
+        }
+    }
+
+    void destroy_node(node * n)
+    {
+        if (m_resource == nullptr)
+        {
+            delete n;
+            return;
+        }
+        n->~node();
+        m_resource->deallocate(n, sizeof(node), alignof(node));
+    }
+
+public:
+    mpsc_queue(memory_resource * resource = nullptr) : // implicit, so a std::array of queues can be list-initialized
+        m_resource(resource),
+        m_head(create_node()),
+        m_tail(m_head.load())
+    {
+    }
+
+    ~mpsc_queue()
+    {
+        while (m_tail != nullptr)
+        {
+            auto next = m_tail->m_next.load(std::memory_order_relaxed);
+            destroy_node(m_tail);
+            m_tail = next;
+        }
+    }
+
+    mpsc_queue(const mpsc_queue &) = delete;
+    mpsc_queue & operator=(const mpsc_queue &) = delete;
+
+    void push(T value)
+    {
+        auto n = create_node(std::move(value));
+        // seq_cst, a consumer that parks after checking empty() must observe this exchange, see venus::parker
+        auto previous = m_head.exchange(n);
+        previous->m_next.store(n, std::memory_order_release);
+    }
+
+    /**
+     * @brief Pushes all elements of [@p first, @p last) with a single atomic exchange.
+     *
+     * The nodes are linked up front, so the elements appear in the queue as one consecutive batch,
+     * values of other producers are never interleaved with them.
+     * Elements are constructed from `*first`, use a std::move_iterator to move them into the queue.
+     */
+    template <typename Iterator>
+    void push_range(Iterator first, Iterator last)
+    {
+        if (first == last)
+        {
+            return;
+        }
+
+        auto batch_first = create_node(T(*first));
+        auto batch_last = batch_first;
+        try
+        {
+            for (++first; first != last; ++first)
+            {
+                auto n = create_node(T(*first));
+                batch_last->m_next.store(n, std::memory_order_relaxed);
+                batch_last = n;
+            }
+        }
+        catch (...)
+        {
+            // nothing was published yet, the queue is unchanged
+            while (batch_first != nullptr)
+            {
+                auto next = batch_first->m_next.load(std::memory_order_relaxed);
+                destroy_node(batch_first);
+                batch_first = next;
+            }
+            throw;
+        }
+
+        auto previous = m_head.exchange(batch_last);
+        previous->m_next.store(batch_first, std::memory_order_release);
+    }
+
+    /**
+     * @brief Takes the oldest value from the queue, if one is available.
+     *
+     * @return `true` if a value was moved into @p value; otherwise, `false`.
+     */
+    [[nodiscard]] bool try_pop(T & value)
+    {
+        auto tail = m_tail;
+        auto next = tail->m_next.load(std::memory_order_acquire);
+        if (next == nullptr)
+        {
+            return false;
+        }
+
+        // 'next' becomes the new stub node, its value is moved out and destroyed with the next pop
+        value = std::move(next->m_value);
+        m_tail = next;
+        destroy_node(tail);
+        return true;
+    }
+
+    /**
+     * @brief Checks whether any value was pushed that was not yet popped.
+     *
+     * @return `false` also when a push has started but its node is not linked yet, in that case
+     *         try_pop() will return a value shortly.
+     */
+    [[nodiscard]] bool empty() const
+    {
+        return m_head.load() == m_tail;
+    }
+};
+
+} // namespace venus
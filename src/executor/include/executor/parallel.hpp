@@ -0,0 +1,291 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#pragma once
+
+#include "executor/future.hpp"
+#include "executor/pool_executor.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace venus {
+
+namespace detail {
+
+// the element of a random-access iterator, or the index itself for an integral 'iterator'
+template <typename It>
+decltype(auto) element(It it, std::false_type)
+{
+    return *it;
+}
+
+template <typename It>
+It element(It it, std::true_type)
+{
+    return it;
+}
+
+template <typename It>
+decltype(auto) element(It it)
+{
+    return element(it, std::is_integral<It>());
+}
+
+/**
+ * @brief The range [first, last) divided into chunks of `m_grain` elements, the last chunk can be smaller.
+ */
+template <typename It>
+struct chunked_range
+{
+    using difference_t = decltype(std::declval<It>() - std::declval<It>());
+
+    chunked_range(It first, It last, std::size_t grain, std::size_t thread_count) :
+        m_first(first),
+        m_size(static_cast<std::size_t>(last - first)),
+        m_grain(grain != 0 ? grain : default_grain(m_size, thread_count))
+    {
+    }
+
+    // about 8 chunks per thread, so the work evens out when some chunks take longer than others
+    static std::size_t default_grain(std::size_t size, std::size_t thread_count)
+    {
+        return std::max<std::size_t>(1, size / (8 * std::max<std::size_t>(1, thread_count)));
+    }
+
+    [[nodiscard]] std::size_t chunk_count() const
+    {
+        return (m_size + m_grain - 1) / m_grain;
+    }
+
+    [[nodiscard]] std::size_t begin(std::size_t chunk) const
+    {
+        return chunk * m_grain;
+    }
+
+    [[nodiscard]] std::size_t end(std::size_t chunk) const
+    {
+        return std::min(m_size, (chunk + 1) * m_grain);
+    }
+
+    [[nodiscard]] It at(std::size_t offset) const
+    {
+        return m_first + static_cast<difference_t>(offset);
+    }
+
+    It m_first;
+    std::size_t m_size;
+    std::size_t m_grain;
+};
+
+/**
+ * @brief Runs `m_chunk(index)` for every chunk index in [0, chunk_count) on the pool and completes a future when all are done.
+ *
+ * A task that covers more than one chunk splits off the upper half of its chunks as a new task, until it covers a single
+ * chunk, which it runs itself. Inside the pool the split off halves go to the local deque of the worker, an idle worker
+ * steals the oldest, so the largest, half. The work spreads over the pool in log2(chunk_count) steps and a worker
+ * that is busy keeps running the chunks that are next to each other.
+ *
+ * When a chunk throws, the chunks that did not start yet are skipped and the future completes with that exception.
+ */
+template <typename ChunkFn>
+class chunked_job
+{
+public:
+    chunked_job(pool_executor & pool, std::size_t chunk_count, ChunkFn chunk) :
+        m_pool(pool),
+        m_chunk(std::move(chunk)),
+        m_remaining(chunk_count)
+    {
+    }
+
+    static future<void> start(pool_executor & pool, std::size_t chunk_count, ChunkFn chunk)
+    {
+        auto job = std::make_shared<chunked_job>(pool, chunk_count, std::move(chunk));
+        auto done = job->m_done.get_future();
+        if (chunk_count == 0)
+        {
+            job->m_done.set_value();
+        }
+        else
+        {
+            pool.add([job, chunk_count]() { run(job, 0, chunk_count); });
+        }
+        return done;
+    }
+
+private:
+    static void run(const std::shared_ptr<chunked_job> & job, std::size_t first, std::size_t last)
+    {
+        while (last - first > 1)
+        {
+            auto middle = first + (last - first) / 2;
+            job->m_pool.add([job, middle, last]() { run(job, middle, last); });
+            last = middle;
+        }
+        job->run_chunk(first);
+    }
+
+    void run_chunk(std::size_t index)
+    {
+        if (!m_failed.load(std::memory_order_relaxed))
+        {
+            try
+            {
+                m_chunk(index);
+            }
+            catch (...)
+            {
+                if (!m_failed.exchange(true))
+                {
+                    m_exception = std::current_exception();
+                }
+            }
+        }
+
+        // the last chunk to finish completes the job, it sees the exception stored by any other chunk
+        if (m_remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            if (m_exception)
+            {
+                m_done.set_exception(m_exception);
+            }
+            else
+            {
+                m_done.set_value();
+            }
+        }
+    }
+
+    pool_executor & m_pool;
+    ChunkFn m_chunk;
+    std::atomic<std::size_t> m_remaining;
+    std::atomic<bool> m_failed = {false};
+    std::exception_ptr m_exception;
+    promise<void> m_done;
+};
+
+template <typename ChunkFn>
+future<void> for_each_chunk(pool_executor & pool, std::size_t chunk_count, ChunkFn chunk)
+{
+    return chunked_job<ChunkFn>::start(pool, chunk_count, std::move(chunk));
+}
+
+} // namespace detail
+
+/**
+ * @brief Calls @p fn for every element of [@p first, @p last) on the threads of @p pool.
+ *
+ * @p first and @p last are random-access iterators, @p fn is called with the element, or they are integers and
+ * @p fn is called with each index. The range is divided into chunks of @p grain elements, with the default of 0 it
+ * is about 8 chunks per thread. Use a larger @p grain when calling @p fn costs less than a microsecond.
+ *
+ * The returned future completes on the pool thread that finishes the last chunk, `.then(executor, fn)` delivers
+ * the completion to a venus::executor, this is the gather step without blocking any thread.
+ */
+template <typename It, typename Fn>
+future<void> parallel_for_async(pool_executor & pool, It first, It last, Fn fn, std::size_t grain = 0)
+{
+    detail::chunked_range<It> range(first, last, grain, pool.thread_count());
+    return detail::for_each_chunk(pool, range.chunk_count(), [range, fn = std::move(fn)](std::size_t chunk) {
+        for (auto offset = range.begin(chunk); offset != range.end(chunk); ++offset)
+        {
+            fn(detail::element(range.at(offset)));
+        }
+    });
+}
+
+/**
+ * @brief Stores `fn(element)` for every element of [@p first, @p last) in the range starting at @p destination.
+ *
+ * @p destination is a random-access iterator with room for all results, the chunks write to disjoint parts of it.
+ *
+ * @return a future that completes with the end of the written range.
+ */
+template <typename It, typename OutIt, typename Fn>
+future<OutIt> parallel_transform_async(pool_executor & pool, It first, It last, OutIt destination, Fn fn, std::size_t grain = 0)
+{
+    detail::chunked_range<It> range(first, last, grain, pool.thread_count());
+    auto destination_last = destination + static_cast<typename std::iterator_traits<OutIt>::difference_type>(range.m_size);
+    return detail::for_each_chunk(pool, range.chunk_count(), [range, destination, fn = std::move(fn)](std::size_t chunk) {
+        for (auto offset = range.begin(chunk); offset != range.end(chunk); ++offset)
+        {
+            destination[static_cast<typename std::iterator_traits<OutIt>::difference_type>(offset)] = fn(detail::element(range.at(offset)));
+        }
+    })
+        .then([destination_last]() { return destination_last; });
+}
+
+/**
+ * @brief Combines all elements of [@p first, @p last) and @p init with @p reduce, like std::reduce.
+ *
+ * Each chunk is reduced on its own and the partial results are combined in the order of the chunks, so @p reduce must
+ * be associative. The grouping of the elements only depends on @p grain and the size of the pool, so for floating point
+ * the result is the same on every run.
+ */
+template <typename It, typename T, typename Reduce>
+future<T> parallel_reduce_async(pool_executor & pool, It first, It last, T init, Reduce reduce, std::size_t grain = 0)
+{
+    detail::chunked_range<It> range(first, last, grain, pool.thread_count());
+    auto partials = std::make_shared<std::vector<T>>(range.chunk_count(), init);
+    auto shared_reduce = std::make_shared<Reduce>(std::move(reduce));
+    return detail::for_each_chunk(pool, range.chunk_count(), [range, partials, shared_reduce](std::size_t chunk) {
+        auto offset = range.begin(chunk);
+        T partial = detail::element(range.at(offset));
+        for (++offset; offset != range.end(chunk); ++offset)
+        {
+            partial = (*shared_reduce)(std::move(partial), detail::element(range.at(offset)));
+        }
+        (*partials)[chunk] = std::move(partial);
+    })
+        .then([partials, shared_reduce, init = std::move(init)]() mutable {
+            for (auto & partial : *partials)
+            {
+                init = (*shared_reduce)(std::move(init), std::move(partial));
+            }
+            return std::move(init);
+        });
+}
+
+/**
+ * @brief Blocking version of parallel_for_async(), it rethrows the first exception thrown by @p fn.
+ *
+ * Must not be called from a task on @p pool, its thread would be blocked while the pool needs it to make progress.
+ */
+template <typename It, typename Fn>
+void parallel_for(pool_executor & pool, It first, It last, Fn fn, std::size_t grain = 0)
+{
+    assert(!pool.is_pool_thread() && "waiting for the pool inside a pool thread can deadlock, use parallel_for_async()");
+    parallel_for_async(pool, first, last, std::move(fn), grain).get();
+}
+
+/**
+ * @brief Blocking version of parallel_transform_async().
+ */
+template <typename It, typename OutIt, typename Fn>
+OutIt parallel_transform(pool_executor & pool, It first, It last, OutIt destination, Fn fn, std::size_t grain = 0)
+{
+    assert(!pool.is_pool_thread() && "waiting for the pool inside a pool thread can deadlock, use parallel_transform_async()");
+    return parallel_transform_async(pool, first, last, destination, std::move(fn), grain).get();
+}
+
+/**
+ * @brief Blocking version of parallel_reduce_async().
+ */
+template <typename It, typename T, typename Reduce>
+T parallel_reduce(pool_executor & pool, It first, It last, T init, Reduce reduce, std::size_t grain = 0)
+{
+    assert(!pool.is_pool_thread() && "waiting for the pool inside a pool thread can deadlock, use parallel_reduce_async()");
+    return parallel_reduce_async(pool, first, last, std::move(init), std::move(reduce), grain).get();
+}
+
+} // namespace venus
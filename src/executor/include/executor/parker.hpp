@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#pragma once
+
+#include "executor/spin_wait.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+namespace venus {
+
+/**
+ * @brief Lets a single consumer thread sleep until a producer signals it, without producers taking a lock
+ * when the consumer is awake.
+ *
+ * The consumer announces it is about to park, then re-checks its @p ready condition, only when that is
+ * still false it actually sleeps on the condition variable. A producer makes its work visible first and
+ * then checks whether the consumer is parked, only then it takes the lock and notifies.
+ * Both sides use sequentially consistent operations, so at least one of them observes the other and no
+ * wakeup is lost.
+ *
+ * Before it parks, the consumer spins on @p ready for a short time (see venus::spin_policy), a producer that
+ * arrives within that time hands over its work without any system call on either side.
+ *
+ * @note A wakeup can be spurious, the consumer must always re-check its own state after park() returns.
+ */
+class parker
+{
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::atomic<bool> m_parked = {false};
+    bool m_signaled = false;
+    spin_policy m_spin;
+
+public:
+    parker() = default;
+
+    explicit parker(spin_policy spin) :
+        m_spin(spin)
+    {
+    }
+
+    /**
+     * @brief Sleeps until @p ready returns `true` or unpark() is called.
+     */
+    template <typename Ready>
+    void park(Ready && ready)
+    {
+        if (spin_until(m_spin, ready))
+        {
+            return;
+        }
+
+        m_parked.store(true);
+        if (!ready())
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this] { return m_signaled; });
+            m_signaled = false;
+        }
+        m_parked.store(false);
+    }
+
+    /**
+     * @brief Sleeps until @p ready returns `true`, unpark() is called or the @p timepoint is reached.
+     *
+     * @return The result of @p ready after waking up.
+     */
+    template <typename Ready, typename Timepoint>
+    bool park_until(Ready && ready, const Timepoint & timepoint)
+    {
+        if (spin_until(m_spin, ready))
+        {
+            return true;
+        }
+
+        m_parked.store(true);
+        if (!ready())
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait_until(lock, timepoint, [this] { return m_signaled; });
+            m_signaled = false;
+        }
+        m_parked.store(false);
+        return ready();
+    }
+
+    /**
+     * @brief Wakes the consumer if it is parked, this is a single atomic load when it is not.
+     */
+    void unpark()
+    {
+        if (!m_parked.load())
+        {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_signaled = true;
+        }
+        m_condition.notify_one();
+    }
+};
+
+} // namespace venus
@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#pragma once
+
+#include "executor/awaitables.hpp"
+#include "executor/rendezvous.hpp"
+#include "executor/scheduled_calls.hpp"
+#include "executor/thread_options.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace venus {
+
+/**
+ * @brief Construction options of a venus::pool_executor.
+ */
+struct pool_options
+{
+    // the number of worker threads, 0 starts one thread per hardware core
+    std::size_t m_thread_count = 0;
+
+    // applied to every worker, a non-empty m_name gets the index of the worker appended, like "pool-3"
+    thread_options m_thread;
+
+    // when not empty, worker i is pinned to the single cpu m_worker_cpus[i % m_worker_cpus.size()],
+    // instead of to all m_thread.m_cpus, so each worker keeps its caches and no two workers share a core.
+    std::vector<std::size_t> m_worker_cpus;
+};
+
+/**
+ * @brief A pool of worker threads that processes independent tasks in parallel.
+ *
+ * Each worker owns a local deque of tasks, work added from outside the pool goes into a global
+ * injection queue. An idle worker first takes from its own deque (newest first), then from the
+ * injection queue (oldest first) and finally steals from a randomly chosen victim (oldest first).
+ *
+ * Tasks added from inside a pool task are pushed onto the local deque of the calling worker,
+ * this keeps related work on the same core unless another worker runs out of work and steals it.
+ *
+ * The pool gives no guarantees on the order in which tasks are executed, or on which thread.
+ */
+class pool_executor
+{
+public:
+    /**
+     * @brief Starts @p thread_count worker threads, when 0 is given one thread per hardware core is started.
+     */
+    explicit pool_executor(std::size_t thread_count = 0);
+
+    /**
+     * @throws std::system_error when the thread options cannot be applied to a worker, no worker is running in that case.
+     */
+    explicit pool_executor(const pool_options & options);
+
+    /**
+     * @brief The destructor of the pool_executor completes all tasks that were added before its invocation.
+     *
+     * Note: users still using the pool_executor during destruction are in violation of the C++ object lifetime rules.
+     */
+    ~pool_executor();
+
+    pool_executor(const pool_executor &) = delete;
+    pool_executor & operator=(const pool_executor &) = delete;
+
+    /**
+     * @brief Runs @p fn on a worker thread and returns its result, or rethrows its exception, in the calling thread.
+     *
+     * @p fn is called by reference and the result is moved back through a rendezvous on the stack of the caller,
+     * so call() does not copy the callable or allocate shared state, only the queued task that refers to both.
+     */
+    template <typename Fn>
+    auto call(Fn && fn)
+    {
+        if (is_pool_thread())
+        {
+            assert(false && "calling call() inside a pool thread is usually a mistake");
+            return fn();
+        }
+
+        detail::rendezvous<decltype(fn())> done;
+        add([&fn, &done] { done.run(fn); });
+        return done.get();
+    }
+
+    template <typename Fn>
+    auto call_async(Fn fn)
+    {
+        // unique_task is move-only, so the packaged_task is moved into the task instead of shared with it.
+        std::packaged_task<decltype(fn())()> task(std::move(fn));
+        auto f = task.get_future();
+        add([task = std::move(task)]() mutable { task(); });
+        return f;
+    }
+
+    void add(venus::function_t function);
+
+    /**
+     * @brief `co_await pool.schedule()` continues a C++20 coroutine on a worker thread of the pool, see executor/coroutine.hpp.
+     */
+    schedule_awaitable<pool_executor> schedule()
+    {
+        return schedule_awaitable<pool_executor>(*this);
+    }
+
+    /**
+     * @brief Checks if the calling thread is one of the worker threads of this pool.
+     */
+    [[nodiscard]] bool is_pool_thread() const;
+
+    [[nodiscard]] std::size_t thread_count() const;
+
+private:
+    struct worker
+    {
+        std::mutex m_mutex;
+        std::deque<function_t> m_tasks;
+        std::uint32_t m_random_state = 0;
+        std::thread m_thread;
+    };
+
+    void run(std::size_t index);
+    void stop();
+    bool try_pop(std::size_t index, function_t & task);
+    bool try_pop_local(worker & self, function_t & task);
+    bool try_pop_global(function_t & task);
+    bool try_steal(std::size_t index, function_t & task);
+    void notify_one();
+
+    std::vector<std::unique_ptr<worker>> m_workers;
+
+    // the global injection queue, also protects the sleeping state of the workers
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<function_t> m_injection_queue;
+
+    // number of tasks that were added but not yet taken by a worker
+    std::atomic<std::size_t> m_pending = {0};
+    std::atomic<std::size_t> m_sleeping = {0};
+    bool m_end = false;
+};
+
+} // namespace venus
@@ -0,0 +1,28 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace venus {
+
+/**
+ * @brief The lane a task is queued in, see executor::add().
+ */
+enum class priority
+{
+    high, // latency-critical work, like control messages
+    normal, // the default
+    background // bulk or maintenance work that can wait
+};
+
+constexpr std::size_t priority_count = 3;
+
+constexpr std::size_t lane_index(priority lane)
+{
+    return static_cast<std::size_t>(lane);
+}
+
+} // namespace venus
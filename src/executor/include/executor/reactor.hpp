@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#pragma once
+
+#include "executor/scheduled_calls.hpp"
+#include "executor/spin_wait.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+
+namespace venus {
+
+/**
+ * @brief Lets a single consumer thread sleep in `epoll_wait` until a producer wakes it, a watched file descriptor
+ * becomes ready or a deadline passes.
+ *
+ * This is the venus::parker of the reactor mode of venus::executor: producers wake the consumer through an eventfd,
+ * the deadline of the first scheduled call is a timerfd, and the callbacks of ready file descriptors are called on the
+ * consumer thread itself, so an I/O event does not need a handoff from another thread.
+ *
+ * The wakeup protocol is that of venus::parker: the consumer announces it is about to sleep and re-checks its @p ready
+ * condition, a producer makes its work visible and only writes to the eventfd when the consumer announced it sleeps,
+ * so a producer makes no system call while the consumer is awake.
+ *
+ * Only wake() can be called from other threads, all other methods belong to the consumer thread.
+ * The reactor is implemented for Linux, elsewhere its constructor throws std::system_error(function_not_supported).
+ */
+class reactor
+{
+public:
+    // called with the ready events, like EPOLLIN or EPOLLOUT
+    using callback_t = std::function<void(std::uint32_t events)>;
+
+    /**
+     * @throws std::system_error when the epoll, eventfd or timerfd descriptor cannot be created.
+     */
+    explicit reactor(spin_policy spin = spin_policy());
+    ~reactor();
+
+    reactor(const reactor &) = delete;
+    reactor & operator=(const reactor &) = delete;
+
+    /**
+     * @brief Calls @p callback when @p fd is ready for @p events (EPOLLIN, EPOLLOUT, EPOLLET, ...), watching an fd again
+     * replaces its events and callback.
+     *
+     * @throws std::system_error when epoll_ctl fails, for example for a closed @p fd.
+     */
+    void watch(int fd, std::uint32_t events, callback_t callback);
+
+    /**
+     * @brief Stops watching @p fd, its callback is not called anymore, also not for events that are already received.
+     *
+     * Call this before closing @p fd.
+     */
+    void unwatch(int fd);
+
+    [[nodiscard]] std::size_t watched_count() const;
+
+    /**
+     * @brief Calls the callbacks of the file descriptors that are ready now, without waiting.
+     *
+     * @return the number of callbacks called.
+     */
+    std::size_t poll();
+
+    /**
+     * @brief Sleeps until @p ready returns `true`, wake() is called, a watched fd is ready or @p deadline is reached,
+     * the callbacks of ready file descriptors are called before it returns.
+     *
+     * @return The result of @p ready after waking up.
+     */
+    template <typename Ready>
+    bool wait_until(Ready && ready, time_point_t deadline)
+    {
+        if (spin_until(m_spin, ready))
+        {
+            return true;
+        }
+
+        m_sleeping.store(true);
+        if (!ready())
+        {
+            block(deadline);
+        }
+        m_sleeping.store(false);
+        return ready();
+    }
+
+    template <typename Ready>
+    void wait(Ready && ready)
+    {
+        wait_until(ready, time_point_t::max());
+    }
+
+    /**
+     * @brief Wakes the consumer if it is sleeping, this is a single atomic load when it is not.
+     */
+    void wake();
+
+private:
+    // one epoll_wait, until an event or @p deadline, time_point_t::max() waits without a deadline
+    void block(time_point_t deadline);
+    std::size_t dispatch(int timeout_ms);
+    void arm_timer(time_point_t deadline);
+    void close_all();
+
+    int m_epoll = -1;
+    int m_event = -1; // eventfd, written by wake()
+    int m_timer = -1; // timerfd, armed for the deadline of block()
+    time_point_t m_armed = time_point_t::max();
+
+    std::atomic<bool> m_sleeping = {false};
+    spin_policy m_spin;
+
+    // shared_ptr, so a callback can unwatch its own fd while it runs
+    std::unordered_map<int, std::shared_ptr<callback_t>> m_callbacks;
+};
+
+} // namespace venus
@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace venus {
+namespace detail {
+
+/**
+ * @brief A one-shot event for a single waiting thread, it lives on the stack of the waiter and does not allocate.
+ *
+ * The waiter spins for a short time (see venus::spin_policy), then sleeps on a futex on Linux, elsewhere on one of a
+ * small, shared pool of condition variables. set() only makes a system call when the waiter is sleeping.
+ * On a single cpu the waiter does not spin, the thread that would set the event cannot run while it does.
+ *
+ * Once the waiter has seen the event, it can destroy it, set() does not touch the event after that point;
+ * the futex wake-up only uses its address.
+ */
+class event
+{
+public:
+    event() = default;
+    event(const event &) = delete;
+    event & operator=(const event &) = delete;
+
+    void set() noexcept
+    {
+        if (m_state.exchange(ready) == sleeping)
+        {
+            wake(&m_state);
+        }
+    }
+
+    void wait() noexcept
+    {
+        if (m_state.load(std::memory_order_acquire) != ready)
+        {
+            sleep();
+        }
+    }
+
+private:
+    static constexpr std::uint32_t empty = 0;
+    static constexpr std::uint32_t sleeping = 1; // the waiter sleeps or is about to, set() must wake it
+    static constexpr std::uint32_t ready = 2;
+
+    void sleep() noexcept; // spins first, if that is useful
+    static void wake(std::atomic<std::uint32_t> * state) noexcept;
+
+    std::atomic<std::uint32_t> m_state = {empty};
+};
+
+/**
+ * @brief Hands the result of a function, or its exception, from the thread that runs it to a thread that waits for it,
+ * like a std::packaged_task and its std::future, but without shared state on the heap.
+ *
+ * The waiting thread owns the rendezvous, it must stay in get() until the other thread called run().
+ */
+template <typename T>
+class rendezvous
+{
+public:
+    rendezvous() = default;
+    rendezvous(const rendezvous &) = delete;
+    rendezvous & operator=(const rendezvous &) = delete;
+
+    ~rendezvous()
+    {
+        if (m_has_value)
+        {
+            value().~T();
+        }
+    }
+
+    template <typename Fn>
+    void run(Fn & fn) noexcept
+    {
+        try
+        {
+            ::new (&m_storage) T(fn());
+            m_has_value = true;
+        }
+        catch (...)
+        {
+            m_exception = std::current_exception();
+        }
+        m_event.set();
+    }
+
+    /**
+     * @brief Waits for run() and moves the result out, or rethrows the exception of the function.
+     */
+    T get()
+    {
+        m_event.wait();
+        if (m_exception)
+        {
+            std::rethrow_exception(m_exception);
+        }
+        return std::move(value());
+    }
+
+private:
+    T & value() noexcept
+    {
+        return *reinterpret_cast<T *>(&m_storage);
+    }
+
+    std::aligned_storage_t<sizeof(T), alignof(T)> m_storage;
+    bool m_has_value = false;
+    std::exception_ptr m_exception;
+    event m_event;
+};
+
+template <typename T>
+class rendezvous<T &>
+{
+public:
+    rendezvous() = default;
+    rendezvous(const rendezvous &) = delete;
+    rendezvous & operator=(const rendezvous &) = delete;
+
+    template <typename Fn>
+    void run(Fn & fn) noexcept
+    {
+        try
+        {
+            m_value = &fn();
+        }
+        catch (...)
+        {
+            m_exception = std::current_exception();
+        }
+        m_event.set();
+    }
+
+    T & get()
+    {
+        m_event.wait();
+        if (m_exception)
+        {
+            std::rethrow_exception(m_exception);
+        }
+        return *m_value;
+    }
+
+private:
+    T * m_value = nullptr;
+    std::exception_ptr m_exception;
+    event m_event;
+};
+
+template <>
+class rendezvous<void>
+{
+public:
+    rendezvous() = default;
+    rendezvous(const rendezvous &) = delete;
+    rendezvous & operator=(const rendezvous &) = delete;
+
+    template <typename Fn>
+    void run(Fn & fn) noexcept
+    {
+        try
+        {
+            fn();
+        }
+        catch (...)
+        {
+            m_exception = std::current_exception();
+        }
+        m_event.set();
+    }
+
+    void get()
+    {
+        m_event.wait();
+        if (m_exception)
+        {
+            std::rethrow_exception(m_exception);
+        }
+    }
+
+private:
+    std::exception_ptr m_exception;
+    event m_event;
+};
+
+} // namespace detail
+} // namespace venus
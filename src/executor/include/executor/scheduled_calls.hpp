@@ -2,7 +2,12 @@
 
 #pragma once
 
+#include "executor/memory_resource.hpp"
+#include "executor/unique_task.hpp"
+
+#include <array>
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <vector>
@@ -12,42 +17,183 @@ namespace venus {
 using clock_t = std::chrono::steady_clock;
 using time_point_t = clock_t::time_point;
 using duration_t = clock_t::duration;
-using function_t = std::function<void()>;
+using function_t = venus::unique_task;
+
+/**
+ * @brief Rounds @p at up to a multiple of the largest power of two nanoseconds that is not larger than @p slack.
+ *
+ * Deadlines that are near each other and have a similar slack are rounded up to the same time point, so they are
+ * due together. Every coarser grid is a multiple of the finer ones, so calls with a different slack line up too.
+ * A deadline is never moved earlier, nor later than `at + slack`.
+ */
+time_point_t coalesce(time_point_t at, duration_t slack);
+
+/**
+ * @brief What happens to the ticks of a repeating call that were missed, because the call or the executor was late.
+ */
+enum class missed_tick_policy
+{
+    catch_up, // run every missed tick, back-to-back (the default)
+    skip, // drop the missed ticks, the next run is at the next tick in the future
+    coalesce // run once for all missed ticks, call_t::m_missed reports how many were folded into that run
+};
 
 struct call_t
 {
-    using id_t = std::uint32_t;
+    using id_t = std::uint64_t;
+    call_t();
     call_t(call_t::id_t id, time_point_t at, function_t function);
     call_t(call_t::id_t id, time_point_t at, duration_t repeat_interval, function_t function);
+    call_t(call_t::id_t id, time_point_t at, duration_t repeat_interval, duration_t slack, function_t function);
+
+    /**
+     * @brief The time the call is due, `m_at` coalesced with the other calls within its `m_slack`.
+     */
+    [[nodiscard]] time_point_t due() const;
 
     call_t::id_t m_id;
     time_point_t m_at;
     duration_t m_repeat_interval;
+    duration_t m_slack; // how much later than m_at the call may run, zero means exactly at m_at
+    missed_tick_policy m_missed_policy;
+    std::size_t m_missed; // the number of ticks that were skipped or coalesced before this run
     function_t m_function;
 };
 
+/**
+ * @brief Stores calls ordered by their deadline, in a hierarchical timing wheel.
+ *
+ * Deadlines are divided into ticks of `tick_duration`, the wheel has `levels` levels of `slots_per_level` slots,
+ * each level covers a 64 times larger range of ticks than the level below it. A call is stored in the lowest
+ * level where its tick falls in the range ahead of the current tick, which is O(1).
+ * When all calls of the first level are processed, the first occupied slot of the next level is cascaded down.
+ * Every call cascades at most `levels` times, so insert(), remove() and pop_and_reschedule() are O(1) amortized.
+ *
+ * Calls that are due at the current tick are kept in a small heap, which orders them by their exact deadline.
+ * Calls with identical deadlines are popped in the order they were inserted.
+ *
+ * The deadline of a call is call_t::due(), a repeating call is rescheduled at `m_at + m_repeat_interval` and
+ * coalesced again from there, so the slack never accumulates.
+ *
+ * The index by id is an open addressing hash table on the full id, which is at most half full, so any ids work,
+ * also the process-wide increasing ones of make_callid(). The entries and the index are allocated from @p resource,
+ * entries of removed calls and their index slots are re-used, so once the largest number of calls was reached,
+ * insert() and remove() do not allocate.
+ *
+ * Compared to a sorted vector, insert() and remove() do not move other calls, but pop_and_reschedule() is slower:
+ * every call is moved down the levels (cascaded) on its way to the front, see scheduled_calls_bench.
+ */
 class scheduled_calls
 {
 public:
+    explicit scheduled_calls(memory_resource * resource = nullptr);
+
     [[nodiscard]] bool empty() const;
+    [[nodiscard]] std::size_t size() const;
     void insert(call_t && call);
-    void remove(call_t::id_t);
+
+    /**
+     * @return `true` if a call with @p id was found and removed.
+     */
+    bool remove(call_t::id_t id);
+
+    /**
+     * @brief Removes all calls for which @p predicate returns `true`, this is O(n).
+     *
+     * @return the ids of the removed calls.
+     */
+    std::vector<call_t::id_t> remove_if(const std::function<bool(const call_t &)> & predicate);
     [[nodiscard]] time_point_t next_deadline() const;
 
     /**
-     * @brief Pops the first task from `m_calls` and potentially reschedules it.
+     * @brief Pops the first task and potentially reschedules it.
      *
-     * This function gets the first task from `m_calls`, and determines
+     * This function gets the first task, and determines
      * whether it should be rescheduled based on its `m_repeat_interval` property.
-     * If the task has a repeat duration, it will be reinserted into the list at an
+     * If the task has a repeat duration, it will be reinserted at an
      * appropriate position based on its next execution time.
      *
-     * @return the first task taken from `m_calls`
+     * The function of a task is move-only, so the rescheduled task is inserted without a function,
+     * the caller hands the function back with restore() after invoking it.
+     *
+     * @return the first task
      */
     call_t pop_and_reschedule();
 
+    /**
+     * @brief Hands the function of a @p call that was returned by pop_and_reschedule() back to its rescheduled task.
+     *
+     * If the rescheduled task was removed in the meantime, the function is destroyed.
+     * When the rescheduled task is already due at @p now, so the call ran late or took longer than its interval,
+     * its `m_missed_policy` decides when it runs next.
+     */
+    void restore(call_t && call, time_point_t now = time_point_t::min());
+
+    static constexpr std::chrono::nanoseconds tick_duration = std::chrono::nanoseconds(1 << 20); // ~1ms
+    static constexpr std::size_t slots_per_level = 64;
+    static constexpr std::size_t levels = 8; // covers 2^48 ticks, more than the range of time_point_t
+
 private:
-    std::vector<call_t> m_calls;
+    using index_t = std::uint32_t;
+    static constexpr index_t npos = ~index_t(0);
+    static constexpr std::uint8_t ready_level = levels; // the entry is in m_ready, not in the wheel
+
+    // the part of an entry that the wheel and the ready heap work on, the call itself is kept apart in `m_calls`,
+    // so cascading and ordering entries touches a few cache lines
+    struct node
+    {
+        time_point_t m_due; // call_t::due(), computed once
+        std::uint64_t m_sequence = 0; // insertion order, breaks ties between identical deadlines
+        std::uint64_t m_tick = 0;
+        index_t m_previous = npos;
+        index_t m_next = npos;
+        std::uint8_t m_level = 0;
+        std::uint8_t m_slot = 0;
+    };
+
+    struct indexed
+    {
+        call_t::id_t m_id = 0;
+        index_t m_entry = npos;
+    };
+
+    indexed * find(call_t::id_t id);
+    std::size_t home_slot(call_t::id_t id) const;
+    void add_index(call_t::id_t id, index_t entry);
+    void erase_index(call_t::id_t id, index_t entry);
+    void grow_index();
+    index_t allocate(call_t && call);
+    void release(index_t index);
+    void place(index_t index);
+    void unlink(index_t index);
+    void remove_ready(index_t index);
+    void push_ready(index_t index);
+    index_t pop_ready();
+    void cascade();
+    bool earlier(index_t a, index_t b) const;
+
+    template <typename T>
+    using vector_t = std::vector<T, polymorphic_allocator<T>>;
+
+    // an entry is the same index in `m_nodes` and `m_calls`
+    vector_t<node> m_nodes;
+    vector_t<call_t> m_calls;
+    vector_t<index_t> m_free;
+    vector_t<indexed> m_index; // linear probing, the size is zero or a power of two, a free slot has m_entry == npos
+    std::size_t m_size = 0;
+
+    std::array<std::array<index_t, slots_per_level>, levels> m_slots;
+    std::array<std::uint64_t, levels> m_occupied = {}; // one bit per non-empty slot
+
+    // heap of the entries with m_tick <= m_current_tick, the first is the entry with the earliest deadline.
+    vector_t<index_t> m_ready;
+
+    std::uint64_t m_current_tick = 0;
+    std::uint64_t m_sequence = 0;
+
+    // next_deadline() scans the first occupied slot, the result is cached until the first entry can have changed
+    mutable bool m_deadline_valid = false;
+    mutable time_point_t m_deadline;
 };
 
 } // namespace venus
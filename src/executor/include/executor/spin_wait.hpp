@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <thread>
+
+namespace venus {
+
+/**
+ * @brief How long a thread busy-waits for a condition before it goes to sleep.
+ *
+ * Waking a sleeping thread costs a system call on both sides and tens of microseconds of latency,
+ * a short spin catches the common case where the other side is only a few microseconds away.
+ */
+struct spin_policy
+{
+    std::uint32_t m_spins = 100; // checks with a cpu pause instruction in between, roughly a microsecond per 25 checks
+    std::uint32_t m_yields = 10; // checks with a std::this_thread::yield() in between
+};
+
+/**
+ * @brief Tells the cpu this is a spin loop, this saves power and makes the spinning hyper-thread yield to its sibling.
+ */
+inline void cpu_relax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield");
+#endif
+}
+
+/**
+ * @brief Checks @p ready until it returns `true`, at most as many times as @p policy allows.
+ *
+ * @return `true` if @p ready returned `true`; `false` if the caller should go to sleep.
+ */
+template <typename Ready>
+bool spin_until(const spin_policy & policy, Ready && ready)
+{
+    for (std::uint32_t i = 0; i < policy.m_spins; ++i)
+    {
+        if (ready())
+        {
+            return true;
+        }
+        cpu_relax();
+    }
+
+    for (std::uint32_t i = 0; i < policy.m_yields; ++i)
+    {
+        if (ready())
+        {
+            return true;
+        }
+        std::this_thread::yield();
+    }
+    return ready();
+}
+
+} // namespace venus
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#pragma once
+
+#include "executor/awaitables.hpp"
+#include "executor/mpsc_queue.hpp"
+#include "executor/pool_executor.hpp"
+#include "executor/rendezvous.hpp"
+#include "executor/scheduled_calls.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <future>
+
+namespace venus {
+
+/**
+ * @brief A serial executor without a thread of its own, its tasks run on the worker threads of a venus::pool_executor.
+ *
+ * A strand gives the same guarantees as venus::executor for the tasks added to it:
+ * - Tasks are executed in the exact order they were added.
+ * - Tasks are executed consecutively (never in parallel), so they can share data without locks.
+ *
+ * A strand is a lock-free task queue and a counter, so one strand per session or per account is cheap, also when
+ * there are tens of thousands of them. When a task is added to an idle strand, one 'drain' task is added to the pool,
+ * it runs the strand's tasks until the queue is empty, or until `batch_size` tasks ran, then it adds itself to the pool
+ * again so other strands get their turn. A task that adds work to another strand from a pool thread, puts the drain
+ * task on the local queue of that worker, so handing off between strands does not involve other threads.
+ *
+ * Exceptions thrown by tasks are ignored, like on venus::executor.
+ */
+class strand
+{
+public:
+    static constexpr std::size_t batch_size = 64;
+
+    explicit strand(pool_executor & pool);
+
+    /**
+     * @brief Waits for all tasks that were added before, they must not add tasks to this strand anymore.
+     */
+    ~strand();
+
+    strand(const strand &) = delete;
+    strand & operator=(const strand &) = delete;
+
+    void add(function_t function);
+
+    /**
+     * @brief `co_await strand.schedule()` continues a C++20 coroutine on this strand, see executor/coroutine.hpp.
+     */
+    schedule_awaitable<strand> schedule()
+    {
+        return schedule_awaitable<strand>(*this);
+    }
+
+    /**
+     * @brief Runs @p fn on the strand and returns its result, or rethrows its exception, in the calling thread.
+     *
+     * @p fn is called by reference and the result is moved back through a rendezvous on the stack of the caller,
+     * so call() does not copy the callable or allocate shared state, only the queued task that refers to both.
+     */
+    template <typename Fn>
+    auto call(Fn && fn)
+    {
+        if (is_current_strand())
+        {
+            assert(false && "calling call() inside the strand is usually a mistake");
+            return fn();
+        }
+
+        detail::rendezvous<decltype(fn())> done;
+        add([&fn, &done] { done.run(fn); });
+        return done.get();
+    }
+
+    template <typename Fn>
+    auto call_async(Fn fn)
+    {
+        std::packaged_task<decltype(fn())()> task(std::move(fn));
+        auto f = task.get_future();
+        add([task = std::move(task)]() mutable { task(); });
+        return f;
+    }
+
+    /**
+     * @brief Blocks until all tasks that were added before have been executed.
+     */
+    void synchronize();
+
+    /**
+     * @brief Checks if the calling thread is running a task of this strand right now.
+     */
+    [[nodiscard]] bool is_current_strand() const;
+
+private:
+    void drain();
+
+    pool_executor & m_pool;
+    mpsc_queue<function_t> m_queue;
+
+    // the number of tasks added but not finished, the thread that raises it from 0 schedules drain()
+    std::atomic<std::size_t> m_pending = {0};
+};
+
+} // namespace venus
@@ -7,10 +7,13 @@
 #include "executor/guarded.hpp"
 #include "executor/scheduled_calls.hpp"
 
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <deque>
+#include <functional>
 #include <mutex>
-#include <queue>
+#include <utility>
 
 /*
  * bool wait_until( std::unique_lock<std::mutex>& lock, const std::chrono::time_point<Clock, Duration>& abs_time, Predicate pred );
@@ -34,44 +37,154 @@
 
 namespace venus {
 
+/**
+ * @brief What push() does when the queue is full.
+ */
+enum class overflow_policy
+{
+    block, // wait until there is room (the default)
+    reject, // do not queue the new element and count it as rejected
+    drop_oldest, // remove the oldest elements until there is room and count them as dropped
+    drop_newest // do not queue the new element and count it as dropped
+};
+
 template <typename T>
 class synchronized_queue
 {
+public:
+    using byte_size_function_t = std::function<size_t(const T &)>;
+
 private:
-    size_t m_maximum_size; // no synchronization needed, set only at construction
+    // no synchronization needed, set only at construction
+    size_t m_maximum_size;
+    size_t m_maximum_bytes;
+    byte_size_function_t m_byte_size;
+    overflow_policy m_policy;
+
+    using TQueue = std::deque<T>;
+    struct state
+    {
+        TQueue m_items;
+        size_t m_bytes = 0; // only maintained when there is a maximum_bytes
+    };
+    mutable guarded_notify<state> m_queue;
+
+    std::atomic<size_t> m_dropped = {0};
+    std::atomic<size_t> m_rejected = {0};
+
+    size_t byte_size(const T & t) const
+    {
+        return m_maximum_bytes == 0 ? 0 : m_byte_size(t);
+    }
+
+    // an element that is larger than maximum_bytes by itself is accepted only by an empty queue.
+    bool has_room(const state & queue, size_t bytes) const
+    {
+        return (m_maximum_size == 0 || queue.m_items.size() < m_maximum_size) &&
+            (m_maximum_bytes == 0 || queue.m_items.empty() || queue.m_bytes + bytes <= m_maximum_bytes);
+    }
+
+    bool is_full(const state & queue) const
+    {
+        return !has_room(queue, 0) || (m_maximum_bytes != 0 && !queue.m_items.empty() && queue.m_bytes >= m_maximum_bytes);
+    }
+
+    void push_back(state & queue, T && t, size_t bytes)
+    {
+        queue.m_items.push_back(std::move(t));
+        queue.m_bytes += bytes;
+    }
+
+    T pop_front(state & queue)
+    {
+        auto result = std::move(queue.m_items.front());
+        queue.m_items.pop_front();
+        queue.m_bytes -= byte_size(result);
+        return result;
+    }
 
-    using TQueue = std::queue<T>;
-    mutable guarded_notify<TQueue> m_queue;
+    // pushes @p t if there is room, otherwise applies the overflow policy, as if it was 'reject' for 'block'.
+    bool push_or_overflow(state & queue, T && t, size_t bytes)
+    {
+        if (has_room(queue, bytes))
+        {
+            push_back(queue, std::move(t), bytes);
+            return true;
+        }
+
+        switch (m_policy)
+        {
+        case overflow_policy::drop_oldest:
+            while (!has_room(queue, bytes))
+            {
+                pop_front(queue);
+                ++m_dropped;
+            }
+            push_back(queue, std::move(t), bytes);
+            return true;
+        case overflow_policy::drop_newest:
+            ++m_dropped;
+            return false;
+        case overflow_policy::block:
+        case overflow_policy::reject:
+            ++m_rejected;
+            return false;
+        }
+        return false;
+    }
 
 public:
-    explicit synchronized_queue(size_t maximum_size = 0) :
-        m_maximum_size(maximum_size)
+    explicit synchronized_queue(size_t maximum_size = 0, overflow_policy policy = overflow_policy::block) :
+        m_maximum_size(maximum_size),
+        m_maximum_bytes(0),
+        m_policy(policy)
+    {
+    }
+
+    /**
+     * @brief Constructs a queue that is also limited by the sum of the sizes of its elements, as reported by @p byte_size.
+     *
+     * @param maximum_size the maximum number of elements, 0 means unlimited.
+     * @param maximum_bytes the maximum sum of `byte_size(element)`, 0 means unlimited.
+     */
+    synchronized_queue(size_t maximum_size, size_t maximum_bytes, byte_size_function_t byte_size, overflow_policy policy = overflow_policy::block) :
+        m_maximum_size(maximum_size),
+        m_maximum_bytes(maximum_bytes),
+        m_byte_size(std::move(byte_size)),
+        m_policy(policy)
     {
     }
 
     [[nodiscard]] bool empty() const
     {
-        return m_queue.with_lock([](TQueue & queue) {
-            return queue.empty();
+        return m_queue.with_lock([](state & queue) {
+            return queue.m_items.empty();
         });
     }
 
     [[nodiscard]] bool full() const
     {
-        if (m_maximum_size == 0)
+        if (m_maximum_size == 0 && m_maximum_bytes == 0)
         {
             return false;
         }
 
-        return m_queue.with_lock([this](const TQueue & queue) {
-            return queue.size() == m_maximum_size;
+        return m_queue.with_lock([this](const state & queue) {
+            return is_full(queue);
         });
     }
 
     [[nodiscard]] size_t size() const
     {
-        return m_queue.with_lock([](const TQueue & queue) {
-            return queue.size();
+        return m_queue.with_lock([](const state & queue) {
+            return queue.m_items.size();
+        });
+    }
+
+    [[nodiscard]] size_t bytes() const
+    {
+        return m_queue.with_lock([](const state & queue) {
+            return queue.m_bytes;
         });
     }
 
@@ -80,15 +193,41 @@ public:
         return m_maximum_size;
     }
 
+    [[nodiscard]] size_t maximum_bytes() const
+    {
+        return m_maximum_bytes;
+    }
+
+    [[nodiscard]] overflow_policy policy() const
+    {
+        return m_policy;
+    }
+
+    /**
+     * @brief The number of elements removed or not queued by the drop_oldest and drop_newest policies.
+     */
+    [[nodiscard]] size_t dropped_count() const
+    {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief The number of elements not queued by the reject policy, or by try_push()/push_until() on a full queue.
+     */
+    [[nodiscard]] size_t rejected_count() const
+    {
+        return m_rejected.load(std::memory_order_relaxed);
+    }
+
     void wait_for_not_full() const
     {
-        if (m_maximum_size == 0)
+        if (m_maximum_size == 0 && m_maximum_bytes == 0)
         {
             return;
         }
 
-        m_queue.wait_for([this](const TQueue & queue) {
-            return queue.size() < m_maximum_size;
+        m_queue.wait_for([this](const state & queue) {
+            return !is_full(queue);
         });
     }
 
@@ -96,17 +235,17 @@ public:
     // test...
     [[nodiscard]] bool wait_for_not_full(std::chrono::nanoseconds duration) const
     {
-        if (m_maximum_size == 0)
+        if (m_maximum_size == 0 && m_maximum_bytes == 0)
         {
             return true;
         }
 
-        return m_queue.wait_for([this](const TQueue & queue) { return queue.size() < m_maximum_size; }, duration);
+        return m_queue.wait_for([this](const state & queue) { return !is_full(queue); }, std::chrono::steady_clock::now() + duration);
     }
 
     void wait_for_not_empty() const
     {
-        m_queue.wait_for([this](const TQueue & queue) { return !queue.empty(); });
+        m_queue.wait_for([](const state & queue) { return !queue.m_items.empty(); });
     }
 
 
@@ -123,21 +262,192 @@ public:
      */
     [[nodiscard]] bool wait_for_not_empty(const time_point_t timepoint) const
     {
-        return m_queue.wait_for([](const TQueue & queue) { return !queue.empty(); }, timepoint);
+        return m_queue.wait_for([](const state & queue) { return !queue.m_items.empty(); }, timepoint);
+    }
+
+    /**
+     * @brief Pushes @p t, when the queue is full the overflow_policy decides what happens.
+     *
+     * @return `true` if @p t was queued; `false` if it was rejected or dropped.
+     */
+    bool push(T t)
+    {
+        if (m_policy != overflow_policy::block)
+        {
+            return try_push(std::move(t));
+        }
+
+        auto bytes = byte_size(t);
+        m_queue.with_lock_and_notify(
+            [&](const state & queue) { return has_room(queue, bytes); },
+            [&](state & queue) { push_back(queue, std::move(t), bytes); });
+        return true;
     }
 
-    void push(T t)
+    /**
+     * @brief Pushes @p t without ever waiting, on a full queue with the 'block' policy @p t is rejected.
+     *
+     * @return `true` if @p t was queued; `false` if it was rejected or dropped.
+     */
+    bool try_push(T t)
     {
+        auto bytes = byte_size(t);
+        bool pushed = false;
         m_queue.with_lock_and_notify(
-            [this](const TQueue & queue) { return m_maximum_size == 0 || queue.size() != m_maximum_size; },
-            [&](TQueue & queue) { queue.push(std::move(t)); });
+            [](const state &) { return true; },
+            [&](state & queue) { pushed = push_or_overflow(queue, std::move(t), bytes); });
+        return pushed;
+    }
+
+    /**
+     * @brief Pushes @p t, with the 'block' policy this waits until there is room or the @p timepoint is reached.
+     *
+     * @return `true` if @p t was queued; `false` if it was rejected (also on timeout) or dropped.
+     */
+    template <typename Timepoint>
+    bool push_until(T t, const Timepoint & timepoint)
+    {
+        if (m_policy != overflow_policy::block)
+        {
+            return try_push(std::move(t));
+        }
+
+        auto bytes = byte_size(t);
+        if (m_queue.with_lock_and_notify_until(
+                [&](const state & queue) { return has_room(queue, bytes); },
+                [&](state & queue) { push_back(queue, std::move(t), bytes); },
+                timepoint))
+        {
+            return true;
+        }
+
+        ++m_rejected;
+        return false;
+    }
+
+    template <typename Rep, typename Period>
+    bool push_for(T t, const std::chrono::duration<Rep, Period> & duration)
+    {
+        return push_until(std::move(t), std::chrono::steady_clock::now() + duration);
+    }
+
+    /**
+     * @brief Pushes all elements of [@p first, @p last) taking the lock once and sending a single notification.
+     *
+     * Elements are constructed from `*first`, use a std::move_iterator to move them into the queue.
+     * On a queue with a maximum_size and the 'block' policy, this blocks until there is room and pushes as many
+     * elements as fit each time, until the whole range is pushed. With the other policies, this never blocks.
+     *
+     * @return the number of elements that were queued.
+     */
+    template <typename Iterator>
+    size_t push_range(Iterator first, Iterator last)
+    {
+        size_t pushed = 0;
+        if (m_policy != overflow_policy::block)
+        {
+            m_queue.with_lock_and_notify_all(
+                [](const state &) { return true; },
+                [&](state & queue) {
+                    for (; first != last; ++first)
+                    {
+                        T t(*first);
+                        auto bytes = byte_size(t);
+                        if (push_or_overflow(queue, std::move(t), bytes))
+                        {
+                            ++pushed;
+                        }
+                    }
+                });
+            return pushed;
+        }
+
+        if (first == last)
+        {
+            return 0;
+        }
+
+        // the element that does not fit is kept until the next round, when there is room for it
+        T t(*first);
+        ++first;
+        auto bytes = byte_size(t);
+        bool done = false;
+        while (!done)
+        {
+            m_queue.with_lock_and_notify_all(
+                [&](const state & queue) { return has_room(queue, bytes); },
+                [&](state & queue) {
+                    for (;;)
+                    {
+                        push_back(queue, std::move(t), bytes);
+                        ++pushed;
+                        if (first == last)
+                        {
+                            done = true;
+                            return;
+                        }
+                        t = T(*first);
+                        ++first;
+                        bytes = byte_size(t);
+                        if (!has_room(queue, bytes))
+                        {
+                            return;
+                        }
+                    }
+                });
+        }
+        return pushed;
     }
 
     T pop()
     {
         return m_queue.with_lock_and_notify_r(
-            [](const TQueue & queue) { return queue.size() > 0; },
-            [&](TQueue & queue) { auto result = queue.front(); queue.pop(); return result; });
+            [](const state & queue) { return !queue.m_items.empty(); },
+            [&](state & queue) { return pop_front(queue); });
+    }
+
+    /**
+     * @brief Pops the oldest element into @p t, without waiting.
+     *
+     * @return `true` if an element was popped; `false` if the queue was empty.
+     */
+    [[nodiscard]] bool try_pop(T & t)
+    {
+        return m_queue.try_with_lock_and_notify(
+            [](const state & queue) { return !queue.m_items.empty(); },
+            [&](state & queue) { t = pop_front(queue); });
+    }
+
+    /**
+     * @brief Pops the oldest element into @p t, waits until there is one or the @p timepoint is reached.
+     *
+     * @return `true` if an element was popped; `false` on timeout.
+     */
+    template <typename Timepoint>
+    [[nodiscard]] bool pop_until(T & t, const Timepoint & timepoint)
+    {
+        return m_queue.with_lock_and_notify_until(
+            [](const state & queue) { return !queue.m_items.empty(); },
+            [&](state & queue) { t = pop_front(queue); },
+            timepoint);
+    }
+
+    template <typename Rep, typename Period>
+    [[nodiscard]] bool pop_for(T & t, const std::chrono::duration<Rep, Period> & duration)
+    {
+        return pop_until(t, std::chrono::steady_clock::now() + duration);
+    }
+
+    /**
+     * @brief Waits until the queue is not empty and then takes all elements out, taking the lock once and sending a single notification.
+     *
+     * @return the elements in the order they were pushed.
+     */
+    std::deque<T> pop_all()
+    {
+        return m_queue.with_lock_and_notify_all_r(
+            [](const state & queue) { return !queue.m_items.empty(); },
+            [](state & queue) { TQueue result; result.swap(queue.m_items); queue.m_bytes = 0; return result; });
     }
 };
 
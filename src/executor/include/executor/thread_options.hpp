@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace venus {
+
+enum class scheduling_policy
+{
+    other,       // SCHED_OTHER, the default time-sharing policy, m_nice applies
+    batch,       // SCHED_BATCH, for cpu-bound background work, m_nice applies
+    idle,        // SCHED_IDLE, only runs when nothing else wants the cpu
+    fifo,        // SCHED_FIFO, real-time, runs until it blocks or a higher m_priority thread is ready
+    round_robin, // SCHED_RR, real-time, like fifo but with a time slice among threads of the same m_priority
+};
+
+/**
+ * @brief Placement and scheduling of a thread started by the library, the defaults leave the thread as it was created.
+ *
+ * The real-time policies and a negative m_nice usually need CAP_SYS_NICE (or an RLIMIT_RTPRIO / RLIMIT_NICE that allows it).
+ * These options are implemented for Linux, elsewhere a non-default option fails with std::errc::function_not_supported.
+ */
+struct thread_options
+{
+    // shown by top, perf and gdb, Linux truncates it to 15 characters
+    std::string m_name;
+
+    // the cpus the thread may run on, empty means all cpus the process may use
+    std::vector<std::size_t> m_cpus;
+
+    scheduling_policy m_policy = scheduling_policy::other;
+
+    // the real-time priority for scheduling_policy::fifo and scheduling_policy::round_robin, 1 (lowest) to 99
+    int m_priority = 0;
+
+    // the nice level for the other policies, -20 (highest) to 19, 0 leaves it unchanged
+    int m_nice = 0;
+};
+
+/**
+ * @brief Applies @p options to the calling thread.
+ *
+ * @throws std::system_error when the operating system rejects an option, for example for lack of permissions.
+ */
+void apply_thread_options(const thread_options & options);
+
+/**
+ * @brief Starts a thread that applies @p options to itself and then runs @p body.
+ *
+ * Returns once the options are applied, so the caller knows the thread is placed as requested.
+ *
+ * @throws std::system_error when @p options cannot be applied, @p body is not run in that case.
+ */
+std::thread start_thread(const thread_options & options, std::function<void()> body);
+
+} // namespace venus
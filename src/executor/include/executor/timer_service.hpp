@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#pragma once
+
+#include "executor/call_handles.hpp"
+#include "executor/mpsc_queue.hpp"
+#include "executor/parker.hpp"
+#include "executor/scheduled_calls.hpp"
+#include "executor/thread_options.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <thread>
+#include <unordered_map>
+
+namespace venus {
+
+/**
+ * @brief Construction options of a venus::timer_service.
+ */
+struct timer_service_options
+{
+    // every call gets at least this much slack, so deadlines of different executors that are near each other are
+    // coalesced into one wakeup of the service thread, see venus::coalesce(). Zero (the default) keeps the slack of each call.
+    duration_t m_minimum_slack = duration_t::zero();
+
+    // how long the service thread spins for new registrations before it sleeps
+    spin_policy m_spin;
+
+    // name, cpu affinity and scheduling of the service thread
+    thread_options m_thread;
+};
+
+/**
+ * @brief One thread with one timing wheel for the scheduled calls of many executors.
+ *
+ * Every venus::executor normally keeps its own scheduled calls and sleeps until the first of them, so dozens of
+ * executors each wake up for their own timers. An executor that is constructed with executor_options::m_timer_service
+ * registers its calls here instead: the service thread sleeps until the first deadline of all executors, runs all calls
+ * that are due in one wakeup, and the function of a call only hands the work over to its executor. Idle executors sleep
+ * without a deadline.
+ *
+ * The function of a call runs on the service thread and should not do more than adding a task to its owner, like
+ * executor::add(). Inside it, due(), missed_ticks() and cancel_current() describe the call that is dispatched.
+ *
+ * insert(), cancel() and remove_owner() can be called from any thread. The service must outlive the executors that use it.
+ */
+class timer_service
+{
+public:
+    /**
+     * @throws std::system_error when @p options.m_thread cannot be applied to the service thread.
+     */
+    explicit timer_service(timer_service_options options = timer_service_options());
+
+    /**
+     * @brief Stops the service thread, the calls that did not run yet are dropped.
+     */
+    ~timer_service();
+
+    timer_service(const timer_service &) = delete;
+    timer_service & operator=(const timer_service &) = delete;
+
+    /**
+     * @brief Schedules @p call, its function is called on the service thread when it is due.
+     *
+     * The id of @p call is replaced by an id of the service, calls of the same @p owner can be removed at once with remove_owner().
+     *
+     * @return the id to cancel() the call with.
+     */
+    call_t::id_t insert(call_t && call, const void * owner = nullptr);
+
+    /**
+     * @brief Cancels the call with @p id, this is lock-free, see executor::cancel().
+     *
+     * The call is removed from the service when it is due, or earlier, once many calls are cancelled.
+     */
+    void cancel(call_t::id_t id);
+
+    /**
+     * @brief Removes all calls of @p owner and blocks until the service thread did so, once this returns none of their
+     * functions is running or will be called anymore.
+     *
+     * Must not be called on the service thread.
+     */
+    void remove_owner(const void * owner);
+
+    [[nodiscard]] bool is_service_thread() const;
+
+    /**
+     * @brief The (coalesced) deadline of the call that is dispatched, only valid inside the function of a call.
+     */
+    [[nodiscard]] time_point_t due() const;
+
+    /**
+     * @brief The ticks of the repeating call that is dispatched, that were skipped or coalesced, see missed_tick_policy.
+     */
+    [[nodiscard]] std::size_t missed_ticks() const;
+
+    /**
+     * @brief Cancels the call that is dispatched, so a repeating call does not run again.
+     */
+    void cancel_current();
+
+    /**
+     * @brief The number of scheduled calls, excluding calls still being registered.
+     */
+    [[nodiscard]] std::size_t size() const;
+
+    /**
+     * @brief The number of times the service thread woke up for due calls, all calls that were due then count as one.
+     */
+    [[nodiscard]] std::uint64_t wakeups() const;
+
+private:
+    struct registration
+    {
+        call_t m_call;
+        const void * m_owner = nullptr;
+    };
+
+    struct removal
+    {
+        const void * m_owner = nullptr;
+        std::promise<void> * m_done = nullptr;
+    };
+
+    void run();
+
+    /**
+     * @brief Moves new calls into `m_calls` and handles the remove_owner() requests, in that order.
+     */
+    void take_requests();
+
+    /**
+     * @brief Pops the first call of `m_calls` and calls its function, its deadline must have expired.
+     */
+    void dispatch();
+
+    void release(call_t::id_t id);
+    void reclaim_cancelled_calls();
+
+    /**
+     * @brief Checks that enough of @p size scheduled calls are cancelled, to remove them all in one pass.
+     */
+    [[nodiscard]] bool should_reclaim(std::size_t size) const;
+    [[nodiscard]] bool has_requests() const;
+
+    scheduled_calls m_calls; // service thread only
+    call_handles m_handles;
+    std::unordered_map<call_t::id_t, const void *> m_owners; // the owner of every call that has one, service thread only
+
+    mpsc_queue<registration> m_registrations;
+    mpsc_queue<removal> m_removals;
+    parker m_parker;
+
+    const duration_t m_minimum_slack;
+
+    // the call that is dispatched, service thread only
+    call_t::id_t m_current = 0;
+    time_point_t m_due;
+    std::size_t m_missed = 0;
+
+    std::atomic<std::size_t> m_size = {0};
+    std::atomic<std::uint64_t> m_wakeups = {0};
+
+    std::atomic<bool> m_end = {false};
+    std::atomic<std::thread::id> m_thread_id = {};
+    std::thread m_thread;
+};
+
+} // namespace venus
@@ -0,0 +1,306 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#pragma once
+
+#include "executor/memory_resource.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace venus {
+
+/**
+ * @brief A move-only `void()` callable, the task type used by all venus executors.
+ *
+ * Unlike std::function, a unique_task does not require the callable to be copyable, so lambdas can
+ * capture move-only objects like std::packaged_task or std::unique_ptr.
+ *
+ * Callables up to `inline_capacity` bytes that are nothrow move constructible are stored inside the
+ * unique_task itself, without any heap allocation. Larger callables are allocated on the heap, or from the
+ * memory_resource that is passed with std::allocator_arg.
+ * A unique_task is exactly one cache line (64 bytes) on 64-bit platforms.
+ */
+class unique_task
+{
+public:
+    static constexpr std::size_t inline_capacity = 64 - sizeof(void *);
+
+    unique_task() noexcept = default;
+
+    unique_task(std::nullptr_t) noexcept // implicit, like std::function
+    {
+    }
+
+    /**
+     * @brief Stores @p fn, a null function pointer or an empty std::function leaves the unique_task empty, like std::function.
+     */
+    template <typename Fn, typename = std::enable_if_t<!std::is_same<std::decay_t<Fn>, unique_task>::value>>
+    unique_task(Fn && fn) // implicit, like std::function
+    {
+        using callable_t = std::decay_t<Fn>;
+        if (is_null(fn))
+        {
+            return;
+        }
+        construct<callable_t>(std::forward<Fn>(fn), std::integral_constant<bool, stored_inline<callable_t>()>());
+    }
+
+    /**
+     * @brief Stores @p fn like the constructor above, but allocates a callable that is not stored inline from @p resource,
+     * a null @p resource uses the heap.
+     */
+    template <typename Fn>
+    unique_task(std::allocator_arg_t, memory_resource * resource, Fn && fn)
+    {
+        using callable_t = std::decay_t<Fn>;
+        if (is_null(fn))
+        {
+            return;
+        }
+        if (resource == nullptr || stored_inline<callable_t>())
+        {
+            construct<callable_t>(std::forward<Fn>(fn), std::integral_constant<bool, stored_inline<callable_t>()>());
+            return;
+        }
+
+        auto memory = resource->allocate(sizeof(callable_t), alignof(callable_t));
+        try
+        {
+            ::new (&m_storage) resource_box<callable_t>{::new (memory) callable_t(std::forward<Fn>(fn)), resource};
+        }
+        catch (...)
+        {
+            resource->deallocate(memory, sizeof(callable_t), alignof(callable_t));
+            throw;
+        }
+        m_operations = &resource_operations<callable_t>::table;
+    }
+
+    unique_task(unique_task && other) noexcept
+    {
+        move_from(other);
+    }
+
+    unique_task & operator=(unique_task && other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            move_from(other);
+        }
+        return *this;
+    }
+
+    unique_task & operator=(std::nullptr_t) noexcept
+    {
+        reset();
+        return *this;
+    }
+
+    unique_task(const unique_task &) = delete;
+    unique_task & operator=(const unique_task &) = delete;
+
+    ~unique_task()
+    {
+        reset();
+    }
+
+    /**
+     * @brief Invokes the stored callable.
+     *
+     * @throws std::bad_function_call when the unique_task is empty, like std::function.
+     */
+    void operator()()
+    {
+        if (m_operations == nullptr)
+        {
+            throw std::bad_function_call();
+        }
+        m_operations->m_invoke(&m_storage);
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return m_operations != nullptr;
+    }
+
+    /**
+     * @brief Checks whether a callable of type @p Fn is stored without a heap allocation.
+     */
+    template <typename Fn>
+    static constexpr bool stored_inline()
+    {
+        return sizeof(Fn) <= inline_capacity && alignof(Fn) <= alignof(storage_t) && std::is_nothrow_move_constructible<Fn>::value;
+    }
+
+private:
+    using storage_t = std::aligned_storage_t<inline_capacity, alignof(void *)>;
+
+    struct operations
+    {
+        void (*m_invoke)(void * storage);
+        // move constructs the callable in @p to and destroys the one in @p from
+        void (*m_relocate)(void * from, void * to) noexcept;
+        void (*m_destroy)(void * storage) noexcept;
+    };
+
+    template <typename Fn>
+    struct inline_operations
+    {
+        static Fn & get(void * storage) noexcept
+        {
+            return *static_cast<Fn *>(storage);
+        }
+
+        static void invoke(void * storage)
+        {
+            get(storage)();
+        }
+
+        static void relocate(void * from, void * to) noexcept
+        {
+            ::new (to) Fn(std::move(get(from)));
+            get(from).~Fn();
+        }
+
+        static void destroy(void * storage) noexcept
+        {
+            get(storage).~Fn();
+        }
+
+        static constexpr operations table = {&invoke, &relocate, &destroy};
+    };
+
+    template <typename Fn>
+    struct heap_operations
+    {
+        static Fn *& get(void * storage) noexcept
+        {
+            return *static_cast<Fn **>(storage);
+        }
+
+        static void invoke(void * storage)
+        {
+            (*get(storage))();
+        }
+
+        static void relocate(void * from, void * to) noexcept
+        {
+            ::new (to) Fn *(get(from));
+        }
+
+        static void destroy(void * storage) noexcept
+        {
+            delete get(storage);
+        }
+
+        static constexpr operations table = {&invoke, &relocate, &destroy};
+    };
+
+    // a callable allocated from a memory_resource, the box itself is stored inline
+    template <typename Fn>
+    struct resource_box
+    {
+        Fn * m_fn;
+        memory_resource * m_resource;
+    };
+
+    template <typename Fn>
+    struct resource_operations
+    {
+        static resource_box<Fn> & get(void * storage) noexcept
+        {
+            return *static_cast<resource_box<Fn> *>(storage);
+        }
+
+        static void invoke(void * storage)
+        {
+            (*get(storage).m_fn)();
+        }
+
+        static void relocate(void * from, void * to) noexcept
+        {
+            ::new (to) resource_box<Fn>(get(from));
+        }
+
+        static void destroy(void * storage) noexcept
+        {
+            auto & box = get(storage);
+            box.m_fn->~Fn();
+            box.m_resource->deallocate(box.m_fn, sizeof(Fn), alignof(Fn));
+        }
+
+        static constexpr operations table = {&invoke, &relocate, &destroy};
+    };
+
+    template <typename Fn>
+    static bool is_null(const Fn &) noexcept
+    {
+        return false;
+    }
+
+    template <typename R, typename... Args>
+    static bool is_null(R (*fn)(Args...)) noexcept
+    {
+        return fn == nullptr;
+    }
+
+    template <typename Signature>
+    static bool is_null(const std::function<Signature> & fn) noexcept
+    {
+        return !fn;
+    }
+
+    template <typename Fn, typename Arg>
+    void construct(Arg && fn, std::true_type /* stored inline */)
+    {
+        ::new (&m_storage) Fn(std::forward<Arg>(fn));
+        m_operations = &inline_operations<Fn>::table;
+    }
+
+    template <typename Fn, typename Arg>
+    void construct(Arg && fn, std::false_type /* stored inline */)
+    {
+        ::new (&m_storage) Fn *(new Fn(std::forward<Arg>(fn)));
+        m_operations = &heap_operations<Fn>::table;
+    }
+
+    void move_from(unique_task & other) noexcept
+    {
+        if (other.m_operations != nullptr)
+        {
+            other.m_operations->m_relocate(&other.m_storage, &m_storage);
+            m_operations = other.m_operations;
+            other.m_operations = nullptr;
+        }
+    }
+
+    void reset() noexcept
+    {
+        if (m_operations != nullptr)
+        {
+            m_operations->m_destroy(&m_storage);
+            m_operations = nullptr;
+        }
+    }
+
+    const operations * m_operations = nullptr;
+    storage_t m_storage;
+};
+
+template <typename Fn>
+constexpr unique_task::operations unique_task::inline_operations<Fn>::table;
+
+template <typename Fn>
+constexpr unique_task::operations unique_task::heap_operations<Fn>::table;
+
+template <typename Fn>
+constexpr unique_task::operations unique_task::resource_operations<Fn>::table;
+
+} // namespace venus
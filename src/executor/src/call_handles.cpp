@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#include "executor/call_handles.hpp"
+
+#include <stdexcept>
+
+namespace venus {
+
+constexpr std::size_t call_handles::chunk_size;
+constexpr std::size_t call_handles::max_chunks;
+
+namespace {
+
+std::uint32_t index_of(call_handles::id_t id)
+{
+    return static_cast<std::uint32_t>(id);
+}
+
+std::uint32_t generation_of(call_handles::id_t id)
+{
+    return static_cast<std::uint32_t>(id >> 32);
+}
+
+call_handles::id_t make_id(std::uint32_t index, std::uint32_t generation)
+{
+    return (static_cast<call_handles::id_t>(generation) << 32) | index;
+}
+
+std::uint64_t active_state(std::uint32_t generation)
+{
+    return static_cast<std::uint64_t>(generation) << 1;
+}
+
+} // namespace
+
+call_handles::call_handles() :
+    m_chunks(new std::atomic<slot *>[max_chunks])
+{
+    for (std::size_t i = 0; i < max_chunks; ++i)
+    {
+        m_chunks[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+call_handles::~call_handles()
+{
+    for (std::size_t i = 0; i < max_chunks; ++i)
+    {
+        delete[] m_chunks[i].load(std::memory_order_relaxed);
+    }
+}
+
+call_handles::id_t call_handles::acquire()
+{
+    // re-use a released slot, its state was moved to the next generation by release()
+    auto head = m_free_head.load(std::memory_order_acquire);
+    while (static_cast<std::uint32_t>(head) != 0)
+    {
+        auto index = static_cast<std::uint32_t>(head) - 1;
+        auto & free_slot = *find(index);
+        auto next = free_slot.m_next_free.load(std::memory_order_relaxed);
+        auto tag = (head >> 32) + 1;
+        if (m_free_head.compare_exchange_weak(head, (tag << 32) | next, std::memory_order_acquire, std::memory_order_acquire))
+        {
+            return make_id(index, static_cast<std::uint32_t>(free_slot.m_state.load(std::memory_order_relaxed) >> 1));
+        }
+    }
+
+    auto index = m_size.fetch_add(1);
+    if (index >= chunk_size * max_chunks)
+    {
+        m_size.fetch_sub(1);
+        throw std::length_error("venus::call_handles: too many scheduled calls");
+    }
+
+    auto & new_slot = get_or_create(index);
+    new_slot.m_state.store(active_state(1), std::memory_order_relaxed);
+    return make_id(index, 1);
+}
+
+bool call_handles::cancel(id_t id)
+{
+    auto cancelled_slot = find(index_of(id));
+    if (cancelled_slot == nullptr)
+    {
+        return false;
+    }
+
+    auto expected = active_state(generation_of(id));
+    if (cancelled_slot->m_state.compare_exchange_strong(expected, expected | 1))
+    {
+        ++m_cancelled;
+        return true;
+    }
+    return false;
+}
+
+bool call_handles::active(id_t id) const
+{
+    auto active_slot = find(index_of(id));
+    return active_slot != nullptr && active_slot->m_state.load(std::memory_order_acquire) == active_state(generation_of(id));
+}
+
+void call_handles::release(id_t id)
+{
+    auto index = index_of(id);
+    auto & released = *find(index);
+
+    auto generation = generation_of(id) + 1;
+    if (generation == 0)
+    {
+        generation = 1; // generation 0 is never used, so no id is ever 0
+    }
+
+    released.m_link.store(0);
+    if (released.m_state.exchange(active_state(generation)) & 1)
+    {
+        --m_cancelled;
+    }
+
+    auto head = m_free_head.load(std::memory_order_relaxed);
+    do
+    {
+        released.m_next_free.store(static_cast<std::uint32_t>(head), std::memory_order_relaxed);
+    } while (!m_free_head.compare_exchange_weak(head, (((head >> 32) + 1) << 32) | (index + 1), std::memory_order_release, std::memory_order_relaxed));
+}
+
+void call_handles::link(id_t id, std::uint64_t value)
+{
+    find(index_of(id))->m_link.store(value);
+}
+
+std::uint64_t call_handles::linked(id_t id) const
+{
+    auto linked_slot = find(index_of(id));
+    if (linked_slot == nullptr || (linked_slot->m_state.load() >> 1) != generation_of(id))
+    {
+        return 0;
+    }
+
+    // the slot can be released and re-used while the value is read, then the generation changed
+    auto value = linked_slot->m_link.load();
+    return (linked_slot->m_state.load() >> 1) == generation_of(id) ? value : 0;
+}
+
+std::size_t call_handles::cancelled_count() const
+{
+    return m_cancelled.load(std::memory_order_relaxed);
+}
+
+call_handles::slot * call_handles::find(std::uint32_t index) const
+{
+    auto chunk_index = index / chunk_size;
+    if (chunk_index >= max_chunks)
+    {
+        return nullptr;
+    }
+
+    auto chunk = m_chunks[chunk_index].load(std::memory_order_acquire);
+    return chunk == nullptr ? nullptr : &chunk[index % chunk_size];
+}
+
+call_handles::slot & call_handles::get_or_create(std::uint32_t index)
+{
+    auto & chunk = m_chunks[index / chunk_size];
+    auto existing = chunk.load(std::memory_order_acquire);
+    if (existing == nullptr)
+    {
+        // another thread can create the same chunk concurrently, the first one to publish it wins
+        auto created = new slot[chunk_size];
+        if (chunk.compare_exchange_strong(existing, created, std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            existing = created;
+        }
+        else
+        {
+            delete[] created;
+        }
+    }
+    return existing[index % chunk_size];
+}
+
+} // namespace venus
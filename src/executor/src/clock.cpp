@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#include "executor/clock.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace venus {
+
+manual_clock::manual_clock(time_point_t start) :
+    m_now(start.time_since_epoch().count())
+{
+}
+
+time_point_t manual_clock::now() const
+{
+    return time_point_t(duration_t(m_now.load()));
+}
+
+time_point_t manual_clock::steady_time(time_point_t deadline) const
+{
+    return deadline <= now() ? time_point_t::min() : time_point_t::max();
+}
+
+void manual_clock::subscribe(const void * owner, listener_t listener)
+{
+    auto added = std::make_shared<subscription>();
+    added->m_owner = owner;
+    added->m_listener = std::move(listener);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_subscriptions.push_back(std::move(added));
+}
+
+void manual_clock::unsubscribe(const void * owner)
+{
+    std::vector<std::shared_ptr<subscription>> removed;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = std::stable_partition(m_subscriptions.begin(), m_subscriptions.end(), [owner](const std::shared_ptr<subscription> & s) {
+            return s->m_owner != owner;
+        });
+        removed.assign(it, m_subscriptions.end());
+        m_subscriptions.erase(it, m_subscriptions.end());
+    }
+
+    // a concurrent advance_to() can still be calling the listener
+    for (auto & s : removed)
+    {
+        while (s->m_calls.load() != 0)
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void manual_clock::advance_to(time_point_t to)
+{
+    auto ticks = to.time_since_epoch().count();
+    auto current = m_now.load();
+    while (current < ticks && !m_now.compare_exchange_weak(current, ticks))
+    {
+    }
+
+    std::vector<std::shared_ptr<subscription>> subscriptions;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        subscriptions = m_subscriptions;
+        for (auto & s : subscriptions)
+        {
+            ++s->m_calls;
+        }
+    }
+
+    // the due calls are posted to all executors before waiting for any of them, so they run in parallel
+    std::vector<std::future<void>> pending;
+    bool on_executor_thread = false;
+    for (auto & s : subscriptions)
+    {
+        struct done_on_exit
+        {
+            subscription & m_subscription;
+
+            ~done_on_exit()
+            {
+                --m_subscription.m_calls;
+            }
+        } done{*s};
+        auto ran = s->m_listener();
+        if (ran.valid())
+        {
+            pending.push_back(std::move(ran));
+        }
+        else
+        {
+            on_executor_thread = true;
+        }
+    }
+
+    // an executor can be blocked on the calling task, waiting for it would never end
+    if (on_executor_thread)
+    {
+        return;
+    }
+
+    for (auto & ran : pending)
+    {
+        ran.wait();
+    }
+}
+
+void manual_clock::advance(duration_t duration)
+{
+    advance_to(now() + duration);
+}
+
+constexpr duration_t scaled_clock::longest_wait;
+
+scaled_clock::scaled_clock(double speed) :
+    m_speed(speed),
+    m_start(clock_t::now())
+{
+    if (!(speed > 0))
+    {
+        throw std::invalid_argument("scaled_clock: the speed must be positive");
+    }
+}
+
+time_point_t scaled_clock::now() const
+{
+    auto elapsed = std::chrono::duration<double, duration_t::period>(clock_t::now() - m_start) * m_speed;
+    return m_start + std::chrono::duration_cast<duration_t>(elapsed);
+}
+
+time_point_t scaled_clock::steady_time(time_point_t deadline) const
+{
+    // in floating point, so the distant deadlines, like time_point_t::max(), do not overflow
+    using fractional_t = std::chrono::duration<double, duration_t::period>;
+    auto remaining = (fractional_t(deadline.time_since_epoch()) - fractional_t(m_start.time_since_epoch())) / m_speed;
+    if (remaining <= fractional_t::zero())
+    {
+        return m_start;
+    }
+
+    // a deadline beyond the longest wait is waited for in steps, the executor thread looks at it again after each one
+    auto steady_now = clock_t::now();
+    if (remaining >= fractional_t(steady_now - m_start) + fractional_t(longest_wait))
+    {
+        return steady_now + longest_wait;
+    }
+    return m_start + std::chrono::duration_cast<duration_t>(remaining);
+}
+
+void scaled_clock::subscribe(const void *, listener_t)
+{
+}
+
+void scaled_clock::unsubscribe(const void *)
+{
+}
+
+} // namespace venus
@@ -8,11 +8,31 @@
 #include <algorithm>
 #include <atomic>
 #include <cassert>
+#include <iterator>
+#include <stdexcept>
 #include <utility>
 
 namespace venus {
 
-[[nodiscard]] scheduled_call::id_t make_callid()
+constexpr std::size_t executor::aging_limit;
+constexpr std::chrono::microseconds executor::reactor_poll_interval;
+
+static_assert(priority_count == 3, "executor::m_lanes is initialized with one queue per lane");
+
+namespace {
+
+clock_source * checked_clock(const executor_options & options)
+{
+    if (options.m_clock != nullptr && options.m_timer_service != nullptr)
+    {
+        throw std::invalid_argument("executor_options::m_clock cannot be combined with m_timer_service");
+    }
+    return options.m_clock;
+}
+
+} // namespace
+
+scheduled_call::id_t make_callid()
 {
     static std::atomic<scheduled_call::id_t> id(0);
     return ++id;
@@ -42,16 +62,56 @@ scheduled_call::id_t scheduled_call::id() const
 
 // executor
 
-executor::executor() :
-    m_thread([this] { run(); })
+executor::executor(executor_options options) :
+    m_arena(options.m_memory_resource != nullptr ? std::make_unique<slab_resource>(options.m_memory_resource) : nullptr),
+    m_lanes{{{m_arena.get()}, {m_arena.get()}, {m_arena.get()}}},
+    m_parker(options.m_spin),
+    m_reactor(options.m_reactor ? std::make_unique<reactor>(options.m_spin) : nullptr),
+    m_scheduled_calls(m_arena.get()),
+    m_timer_service(options.m_timer_service),
+    m_clock(checked_clock(options)),
+    m_registrations(m_arena.get()),
+    m_busy_poll(options.m_busy_poll && !options.m_reactor),
+    m_precision_window(std::max(options.m_precision_window, duration_t::zero())),
+    m_thread(start_thread(options.m_thread, [this] { run(); }))
 {
     synchronize();
+    if (m_clock != nullptr)
+    {
+        // on the executor thread, the loop looks at the new time once the running call returns
+        m_clock->subscribe(this, [this] {
+            if (is_executor_thread())
+            {
+                return std::future<void>();
+            }
+            return call_async([this] { run_due_calls(); });
+        });
+    }
 }
 
 executor::~executor()
 {
-    add([this] { m_end = true; });
+    if (m_clock != nullptr)
+    {
+        m_clock->unsubscribe(this);
+    }
+
+    add_after_all_lanes([this] { m_end = true; });
     m_thread.join();
+
+    // the service can still add a due call while the thread ends, those tasks release their call into m_handles,
+    // so they are destroyed here, before the members
+    if (m_timer_service != nullptr)
+    {
+        m_timer_service->remove_owner(this);
+        queued_task task;
+        for (auto & lane : m_lanes)
+        {
+            while (lane.try_pop(task))
+            {
+            }
+        }
+    }
 }
 
 bool executor::is_executor_thread() const
@@ -59,52 +119,284 @@ bool executor::is_executor_thread() const
     return std::this_thread::get_id() == m_threadId;
 }
 
-void executor::add(std::function<void()> fn)
+void executor::add(function_t function, priority lane)
+{
+    m_counters.on_submit(lane, 1);
+    m_lanes[lane_index(lane)].push(queued_task{std::move(function), clock_t::now()});
+    wake();
+}
+
+void executor::add_bulk(std::vector<function_t> functions, priority lane)
+{
+    m_counters.on_submit(lane, functions.size());
+    auto now = clock_t::now();
+    std::vector<queued_task> tasks;
+    tasks.reserve(functions.size());
+    for (auto & function : functions)
+    {
+        tasks.push_back(queued_task{std::move(function), now});
+    }
+    m_lanes[lane_index(lane)].push_range(std::make_move_iterator(tasks.begin()), std::make_move_iterator(tasks.end()));
+    wake();
+}
+
+void executor::add_after_all_lanes(function_t function)
 {
-    m_queue.push(fn);
+    struct barrier
+    {
+        std::size_t m_remaining = priority_count; // only touched by the executor thread
+        function_t m_function;
+    };
+
+    auto shared_barrier = std::make_shared<barrier>();
+    shared_barrier->m_function = std::move(function);
+    for (std::size_t i = 0; i < priority_count; ++i)
+    {
+        add([shared_barrier] {
+            if (--shared_barrier->m_remaining == 0)
+            {
+                shared_barrier->m_function();
+            }
+        },
+            static_cast<priority>(i));
+    }
+}
+
+void executor::watch(int fd, std::uint32_t events, reactor::callback_t callback)
+{
+    if (!m_reactor)
+    {
+        throw std::logic_error("executor::watch() requires executor_options::m_reactor");
+    }
+
+    if (!is_executor_thread())
+    {
+        call([&] { watch(fd, events, std::move(callback)); });
+        return;
+    }
+    m_reactor->watch(fd, events, std::move(callback));
+}
+
+void executor::unwatch(int fd)
+{
+    if (!m_reactor)
+    {
+        return;
+    }
+
+    if (!is_executor_thread())
+    {
+        call([&] { unwatch(fd); });
+        return;
+    }
+    m_reactor->unwatch(fd);
+}
+
+time_point_t executor::now() const
+{
+    return m_clock != nullptr ? m_clock->now() : clock_t::now();
+}
+
+duration_t executor::lateness() const
+{
+    return m_lateness;
+}
+
+executor_stats executor::stats() const
+{
+    auto stats = m_counters.snapshot();
+    if (m_arena)
+    {
+        stats.m_memory = m_arena->stats();
+    }
+    return stats;
+}
+
+memory_resource * executor::arena() const
+{
+    return m_arena.get();
 }
 
 void executor::synchronize()
 {
     assert(!is_executor_thread() && "Calling synchronize() inside call() will cause a deadlock");
-    std::promise<bool> sync;
-    add([&sync]() { sync.set_value(true); });
-    sync.get_future().get();
+
+    // like add_after_all_lanes(), but the barrier lives on this stack, the tasks only refer to it
+    struct barrier
+    {
+        std::size_t m_remaining = priority_count; // only touched by the executor thread
+        detail::event m_done;
+    } sync;
+
+    for (std::size_t i = 0; i < priority_count; ++i)
+    {
+        add([&sync] {
+            if (--sync.m_remaining == 0)
+            {
+                sync.m_done.set();
+            }
+        },
+            static_cast<priority>(i));
+    }
+    sync.m_done.wait();
+}
+
+scheduled_call executor::call_at(const time_point_t & at, function_t function, const duration_t & slack)
+{
+    return call_every(at, {}, std::move(function), slack);
 }
 
-scheduled_call executor::call_at(const time_point_t & at, function_t function)
+scheduled_call executor::call_after(const duration_t & delay, function_t function, const duration_t & slack)
 {
-    return call_every(at, {}, function);
+    return call_at(now() + delay, std::move(function), slack);
 }
 
-scheduled_call executor::call_after(const duration_t & delay, function_t function)
+scheduled_call executor::call_every(const duration_t & repeat_interval, function_t function, const duration_t & slack)
 {
-    return call_at(std::chrono::steady_clock::now() + delay, function);
+    return call_every(now(), repeat_interval, std::move(function), slack);
 }
 
-scheduled_call executor::call_every(const duration_t & repeat_interval, function_t function)
+scheduled_call executor::call_every(const time_point_t & at, const duration_t & repeat_interval, function_t function, const duration_t & slack)
 {
-    return call_every(std::chrono::steady_clock::now(), repeat_interval, function);
+    return register_call(call_t(m_handles.acquire(), at, repeat_interval, slack, std::move(function)));
 }
 
-scheduled_call executor::call_every(const time_point_t & at, const duration_t & repeat_interval, function_t function)
+scheduled_call executor::register_call(call_t && call)
 {
-    auto id = make_callid();
-    add([this, id, at, repeat_interval, function]() {
-        m_scheduled_calls.insert(venus::call_t(id, at, repeat_interval, function));
-    });
+    auto id = call.m_id;
+    if (m_timer_service != nullptr)
+    {
+        register_shared_call(std::move(call));
+    }
+    else if (is_executor_thread())
+    {
+        insert_scheduled_call(std::move(call));
+    }
+    else
+    {
+        m_registrations.push(std::move(call));
+        wake();
+    }
     return scheduled_call(*this, id);
 }
 
+void executor::insert_scheduled_call(call_t && call)
+{
+    if (!m_handles.active(call.m_id))
+    {
+        m_handles.release(call.m_id);
+        return;
+    }
+    m_scheduled_calls.insert(std::move(call));
+}
+
+executor::shared_call::shared_call(call_handles & handles, call_t::id_t id, function_t function, bool repeating, missed_tick_policy policy) :
+    m_handles(handles),
+    m_id(id),
+    m_function(std::move(function)),
+    m_repeating(repeating),
+    m_policy(policy)
+{
+}
+
+executor::shared_call::~shared_call()
+{
+    m_handles.release(m_id);
+}
+
+void executor::register_shared_call(call_t && call)
+{
+    auto id = call.m_id;
+    auto shared = std::allocate_shared<shared_call>(polymorphic_allocator<shared_call>(m_arena.get()), m_handles, id, std::move(call.m_function), call.m_repeat_interval != duration_t::zero(), call.m_missed_policy);
+    call.m_function = [this, shared] { dispatch_shared_call(shared); };
+
+    // cancel() looks up the id of the service to drop the call before its deadline
+    auto service_id = m_timer_service->insert(std::move(call), this);
+    m_handles.link(id, service_id);
+    if (!m_handles.active(id))
+    {
+        m_timer_service->cancel(service_id); // cancelled before it was linked
+    }
+}
+
+void executor::dispatch_shared_call(const std::shared_ptr<shared_call> & call)
+{
+    if (!m_handles.active(call->m_id))
+    {
+        m_timer_service->cancel_current();
+        return;
+    }
+
+    call->m_missed += m_timer_service->missed_ticks();
+    if (call->m_repeating && call->m_policy != missed_tick_policy::catch_up && call->m_queued.exchange(true))
+    {
+        // the previous tick did not run yet, this one is skipped or coalesced into it
+        ++call->m_missed;
+        return;
+    }
+    add([this, call, due = m_timer_service->due()] { run_shared_call(*call, due); });
+}
+
+void executor::run_shared_call(shared_call & call, time_point_t due)
+{
+    if (!m_handles.active(call.m_id))
+    {
+        return;
+    }
+
+    m_lateness = clock_t::now() - due;
+    m_counters.on_scheduled_call(m_lateness);
+
+    // the next tick can be added once this one ran, also when it throws
+    struct dequeue_on_exit
+    {
+        shared_call & m_call;
+
+        ~dequeue_on_exit()
+        {
+            m_call.m_queued = false;
+        }
+    } dequeue{call};
+
+    m_missed_ticks = call.m_missed.exchange(0);
+    call.m_function();
+}
+
 void executor::cancel(const call_t::id_t id)
 {
-    if (is_executor_thread())
+    if (m_timer_service != nullptr)
     {
-        m_scheduled_calls.remove(id);
+        // the service drops the call from its wheel, 0 when it is not linked yet, register_shared_call() cancels it then
+        auto service_id = m_handles.cancel(id) ? m_handles.linked(id) : 0;
+        if (service_id != 0)
+        {
+            m_timer_service->cancel(service_id);
+        }
+        return;
     }
-    else
+
+    m_handles.cancel(id);
+
+    // on the executor thread, the call is reclaimed immediately, unless it is not in m_scheduled_calls;
+    // because it is still in m_registrations or is running right now.
+    if (is_executor_thread() && m_scheduled_calls.remove(id))
+    {
+        m_handles.release(id);
+    }
+}
+
+void executor::reclaim_cancelled_calls()
+{
+    constexpr std::size_t minimum_cancelled = 1024;
+    auto cancelled = m_handles.cancelled_count();
+    if (cancelled < minimum_cancelled || cancelled * 2 < m_scheduled_calls.size())
+    {
+        return;
+    }
+
+    for (auto id : m_scheduled_calls.remove_if([this](const call_t & call) { return !m_handles.active(call.m_id); }))
     {
-        call([this, id]() { m_scheduled_calls.remove(id); });
+        m_handles.release(id);
     }
 }
 
@@ -130,22 +422,265 @@ void executor::run()
 
 void executor::run_one()
 {
-    // if there are scheduled_calls and the deadline of first call expires, execute it.
-    if (!m_scheduled_calls.empty() && !wait_for_work(m_scheduled_calls.next_deadline()))
+    m_counters.set_scheduled_calls(m_scheduled_calls.size());
+
+    queued_task task;
+    priority lane = priority::normal;
+    if (try_pop_task(task, lane))
     {
-        m_scheduled_calls.pop_and_reschedule().m_function();
+        // drain the batch of available tasks before m_scheduled_calls is checked again,
+        // the end of one task is the start of the next, so there is one clock read per task.
+        auto start = clock_t::now();
+        std::size_t drained = 0;
+        do
+        {
+            if (drained++ % executor_counters::drain_interval == 0)
+            {
+                m_counters.on_drain();
+            }
+            m_counters.on_start(lane, start - task.m_enqueued);
+            task.m_function();
+            auto end = clock_t::now();
+            m_counters.on_task_done(end - start);
+            poll_reactor(end);
+            start = end;
+        } while (!m_end && try_pop_task(task, lane));
+        return;
     }
-    else
+
+    call_t call;
+    while (m_registrations.try_pop(call))
+    {
+        insert_scheduled_call(std::move(call));
+    }
+    m_counters.set_scheduled_calls(m_scheduled_calls.size());
+
+    if (!lanes_empty() || !m_registrations.empty())
+    {
+        // a producer is between claiming its place in the queue and linking its task, it will be there shortly.
+        std::this_thread::yield();
+        return;
+    }
+
+    // m_lanes are empty, if the deadline of the first scheduled_call has expired, execute it.
+    if (!m_scheduled_calls.empty())
     {
-        // either there are no scheduled_calls and pop() will block until there is work to do
-        // or `wait_for_work` returned `true` and there is work to do.
-        return m_queue.pop()();
+        reclaim_cancelled_calls();
+        if (m_scheduled_calls.empty())
+        {
+            return;
+        }
+
+        auto deadline = m_scheduled_calls.next_deadline();
+        auto steady_now = clock_t::now();
+        if ((m_clock != nullptr ? m_clock->now() : steady_now) >= deadline)
+        {
+            poll_reactor(steady_now);
+            run_scheduled_call();
+        }
+        else
+        {
+            wait_for_work(deadline);
+        }
+        return;
     }
+
+    // there are no scheduled_calls, sleep until there is work to do
+    wait_for_work();
 }
 
-bool executor::wait_for_work(const time_point_t timepoint) const
+bool executor::try_pop_task(queued_task & task, priority & lane)
 {
-    return m_queue.wait_for_not_empty(timepoint);
+    // a lower lane that was passed over aging_limit times gets a turn first, the lowest lane is the oldest in that case
+    for (auto i = priority_count - 1; i > 0; --i)
+    {
+        if (m_passed_over[i] >= aging_limit && m_lanes[i].try_pop(task))
+        {
+            m_passed_over[i] = 0;
+            lane = static_cast<priority>(i);
+            return true;
+        }
+    }
+
+    for (std::size_t i = 0; i < priority_count; ++i)
+    {
+        if (m_lanes[i].try_pop(task))
+        {
+            m_passed_over[i] = 0;
+            for (auto lower = i + 1; lower < priority_count; ++lower)
+            {
+                m_passed_over[lower] = m_lanes[lower].empty() ? 0 : m_passed_over[lower] + 1;
+            }
+            lane = static_cast<priority>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool executor::lanes_empty() const
+{
+    for (auto & queue : m_lanes)
+    {
+        if (!queue.empty())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void executor::run_scheduled_call()
+{
+    auto call = m_scheduled_calls.pop_and_reschedule();
+    auto repeating = call.m_repeat_interval != duration_t::zero();
+    if (!m_handles.active(call.m_id))
+    {
+        // cancelled by another thread
+        if (repeating)
+        {
+            m_scheduled_calls.remove(call.m_id);
+        }
+        m_handles.release(call.m_id);
+        return;
+    }
+
+    m_lateness = now() - call.due();
+    m_counters.on_scheduled_call(m_lateness);
+    if (!repeating)
+    {
+        m_handles.release(call.m_id);
+        call.m_function();
+        return;
+    }
+
+    // the rescheduled call gets its function back, also when it throws.
+    struct restore_on_exit
+    {
+        executor & m_executor;
+        call_t & m_call;
+
+        ~restore_on_exit()
+        {
+            // only the other policies look at ticks that were missed while the call ran
+            auto now = m_call.m_missed_policy == missed_tick_policy::catch_up ? time_point_t::min() : m_executor.now();
+            m_executor.m_scheduled_calls.restore(std::move(m_call), now);
+        }
+    } restore{*this, call};
+
+    m_missed_ticks = call.m_missed;
+    call.m_function();
+}
+
+void executor::run_due_calls()
+{
+    call_t call;
+    while (m_registrations.try_pop(call))
+    {
+        insert_scheduled_call(std::move(call));
+    }
+
+    while (!m_scheduled_calls.empty() && m_scheduled_calls.next_deadline() <= now())
+    {
+        try
+        {
+            run_scheduled_call();
+        }
+        catch (...)
+        {
+            // ignored, like in run()
+        }
+    }
+}
+
+void executor::wake()
+{
+    if (m_reactor)
+    {
+        m_reactor->wake();
+        return;
+    }
+    m_parker.unpark();
+}
+
+void executor::poll_reactor(const time_point_t now)
+{
+    if (m_reactor && now - m_last_poll >= reactor_poll_interval)
+    {
+        m_reactor->poll();
+        m_last_poll = now;
+    }
+}
+
+void executor::wait_for_work()
+{
+    auto ready = [this] { return !lanes_empty() || !m_registrations.empty(); };
+    if (m_reactor)
+    {
+        m_reactor->wait(ready);
+        m_last_poll = clock_t::now();
+        return;
+    }
+    if (m_busy_poll)
+    {
+        while (!ready())
+        {
+            cpu_relax();
+        }
+        return;
+    }
+    m_parker.park(ready);
+}
+
+bool executor::wait_for_work(const time_point_t deadline)
+{
+    auto ready = [this] { return !lanes_empty() || !m_registrations.empty(); };
+
+    // the deadline is in the time of m_clock, the executor thread waits in steady_clock time
+    auto timepoint = m_clock != nullptr ? m_clock->steady_time(deadline) : deadline;
+    if (timepoint == time_point_t::max())
+    {
+        // the clock calls run_due_calls() when it is advanced
+        wait_for_work();
+        return ready();
+    }
+    if (timepoint == time_point_t::min())
+    {
+        // the clock moved past the deadline after it was checked, the deadline is due
+        return ready();
+    }
+
+    if (m_busy_poll)
+    {
+        while (!ready() && clock_t::now() < timepoint)
+        {
+            cpu_relax();
+        }
+        return ready();
+    }
+
+    // in the precision timer mode the sleep ends early and the last part of the wait is spent spinning
+    auto wake_at = timepoint < time_point_t::min() + m_precision_window ? time_point_t::min() : timepoint - m_precision_window;
+    bool woken = false;
+    if (m_reactor)
+    {
+        woken = m_reactor->wait_until(ready, wake_at);
+        m_last_poll = clock_t::now();
+    }
+    else
+    {
+        woken = m_parker.park_until(ready, wake_at);
+    }
+
+    if (woken || m_precision_window == duration_t::zero())
+    {
+        return woken;
+    }
+    while (!ready() && clock_t::now() < timepoint)
+    {
+        cpu_relax();
+    }
+    return ready();
 }
 
 } // namespace venus
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#include "executor/executor_stats.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace venus {
+
+constexpr std::size_t duration_histogram::bucket_count;
+constexpr std::size_t executor_counters::drain_interval;
+constexpr std::size_t executor_counters::cache_line_size;
+
+std::uint64_t duration_histogram::count() const
+{
+    std::uint64_t result = 0;
+    for (auto count : m_buckets)
+    {
+        result += count;
+    }
+    return result;
+}
+
+std::chrono::nanoseconds duration_histogram::percentile(double fraction) const
+{
+    auto total = count();
+    if (total == 0)
+    {
+        return std::chrono::nanoseconds::zero();
+    }
+
+    auto rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(fraction * static_cast<double>(total))));
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < bucket_count; ++i)
+    {
+        seen += m_buckets[i];
+        if (seen >= rank)
+        {
+            return upper_bound(i);
+        }
+    }
+    return upper_bound(bucket_count - 1);
+}
+
+std::size_t duration_histogram::bucket(std::chrono::nanoseconds duration)
+{
+    auto count = duration.count();
+    if (count <= 0)
+    {
+        return 0;
+    }
+    return static_cast<std::size_t>(64 - __builtin_clzll(static_cast<std::uint64_t>(count)));
+}
+
+std::chrono::nanoseconds duration_histogram::upper_bound(std::size_t bucket)
+{
+    if (bucket == 0)
+    {
+        return std::chrono::nanoseconds::zero();
+    }
+    if (bucket >= 63)
+    {
+        return std::chrono::nanoseconds::max();
+    }
+    return std::chrono::nanoseconds(std::int64_t{1} << bucket);
+}
+
+void executor_counters::histogram::record(std::chrono::nanoseconds duration)
+{
+    increment(m_buckets[duration_histogram::bucket(duration)]);
+}
+
+void executor_counters::histogram::copy_to(duration_histogram & snapshot) const
+{
+    for (std::size_t i = 0; i < duration_histogram::bucket_count; ++i)
+    {
+        snapshot.m_buckets[i] = m_buckets[i].load(std::memory_order_relaxed);
+    }
+}
+
+void executor_counters::increment(std::atomic<std::uint64_t> & counter)
+{
+    // single writer, a load and store is cheaper than fetch_add
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void executor_counters::on_submit(priority lane, std::uint64_t count)
+{
+    m_submitted[lane_index(lane)].fetch_add(count, std::memory_order_relaxed);
+}
+
+void executor_counters::on_drain()
+{
+    std::uint64_t depth = 0;
+    for (std::size_t i = 0; i < priority_count; ++i)
+    {
+        auto submitted = m_submitted[i].load(std::memory_order_relaxed);
+        auto executed = m_executed[i].load(std::memory_order_relaxed);
+        depth += submitted > executed ? submitted - executed : 0;
+    }
+
+    // single writer
+    if (depth > m_peak_queue_depth.load(std::memory_order_relaxed))
+    {
+        m_peak_queue_depth.store(depth, std::memory_order_relaxed);
+    }
+}
+
+void executor_counters::on_start(priority lane, std::chrono::nanoseconds queue_wait)
+{
+    increment(m_executed[lane_index(lane)]);
+    m_queue_wait.record(queue_wait);
+}
+
+void executor_counters::on_task_done(std::chrono::nanoseconds duration)
+{
+    m_task_duration.record(duration);
+}
+
+void executor_counters::on_scheduled_call(std::chrono::nanoseconds lateness)
+{
+    increment(m_scheduled_calls_executed);
+    m_lateness.record(lateness);
+}
+
+void executor_counters::set_scheduled_calls(std::size_t count)
+{
+    m_scheduled_calls.store(count, std::memory_order_relaxed);
+}
+
+executor_stats executor_counters::snapshot() const
+{
+    executor_stats stats;
+    for (std::size_t i = 0; i < priority_count; ++i)
+    {
+        auto executed = m_executed[i].load(std::memory_order_relaxed);
+        auto submitted = std::max(m_submitted[i].load(std::memory_order_relaxed), executed);
+        stats.m_executed += executed;
+        stats.m_submitted += submitted;
+        stats.m_lane_depth[i] = submitted - executed;
+        stats.m_queue_depth += submitted - executed;
+    }
+    stats.m_peak_queue_depth = m_peak_queue_depth.load(std::memory_order_relaxed);
+    stats.m_scheduled_calls = m_scheduled_calls.load(std::memory_order_relaxed);
+    stats.m_scheduled_calls_executed = m_scheduled_calls_executed.load(std::memory_order_relaxed);
+    m_queue_wait.copy_to(stats.m_queue_wait);
+    m_task_duration.copy_to(stats.m_task_duration);
+    m_lateness.copy_to(stats.m_lateness);
+    return stats;
+}
+
+} // namespace venus
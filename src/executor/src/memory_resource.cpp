@@ -0,0 +1,589 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#include "executor/memory_resource.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+namespace venus {
+
+namespace {
+
+class new_delete_memory_resource : public memory_resource
+{
+private:
+    void * do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        if (alignment > alignof(std::max_align_t))
+        {
+#if defined(__linux__)
+            // without a header in front of the block, a slab that is aligned to its size takes no extra page
+            void * block = nullptr;
+            if (::posix_memalign(&block, alignment, bytes) != 0)
+            {
+                throw std::bad_alloc();
+            }
+            return block;
+#else
+            // over-aligned operator new is C++17, over-allocate and keep the raw pointer in front of the aligned block
+            auto raw = ::operator new(bytes + alignment + sizeof(void *));
+            auto address = reinterpret_cast<std::uintptr_t>(raw) + sizeof(void *);
+            address += alignment - 1 - (address + alignment - 1) % alignment;
+            auto block = reinterpret_cast<void **>(address);
+            block[-1] = raw;
+            return block;
+#endif
+        }
+        return ::operator new(bytes);
+    }
+
+    void do_deallocate(void * p, std::size_t, std::size_t alignment) override
+    {
+        if (alignment > alignof(std::max_align_t))
+        {
+#if defined(__linux__)
+            std::free(p);
+#else
+            ::operator delete(static_cast<void **>(p)[-1]);
+#endif
+            return;
+        }
+        ::operator delete(p);
+    }
+
+    bool do_is_equal(const memory_resource & other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+} // namespace
+
+memory_resource * new_delete_resource() noexcept
+{
+    static new_delete_memory_resource resource;
+    return &resource;
+}
+
+// slab_resource
+
+constexpr std::size_t slab_resource::min_block_size;
+constexpr std::size_t slab_resource::size_class_count;
+constexpr std::size_t slab_resource::max_block_size;
+constexpr std::size_t slab_resource::slab_size;
+constexpr std::size_t slab_resource::slab_chunk_size;
+constexpr std::size_t slab_resource::max_slab_chunks;
+constexpr std::uint32_t slab_resource::batch_size;
+
+namespace {
+
+// a block id is the slab number in the high bits and the block in the slab in the low bits
+constexpr std::size_t block_bits = 12;
+constexpr std::uint32_t block_mask = (std::uint32_t(1) << block_bits) - 1;
+constexpr std::size_t min_block_shift = 4;
+static_assert(std::size_t(1) << min_block_shift == slab_resource::min_block_size, "min_block_shift must match min_block_size");
+static_assert(slab_resource::slab_size / slab_resource::min_block_size <= block_mask + 1, "a slab has too many blocks for the block ids");
+// the header takes at least one block, so the last block of a slab is at most slab_size / min_block_size - 2
+static_assert(((slab_resource::slab_chunk_size * slab_resource::max_slab_chunks - 1) << block_bits) + slab_resource::slab_size / slab_resource::min_block_size - 1 <=
+                  std::numeric_limits<std::uint32_t>::max(),
+              "the largest block id + 1 must fit in 32 bits");
+
+std::size_t round_up(std::size_t value, std::size_t multiple)
+{
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+std::size_t first_block_offset(std::size_t block_size, std::size_t blocks)
+{
+    return round_up(sizeof(std::uint32_t) + blocks * sizeof(std::atomic<std::uint32_t>), block_size);
+}
+
+// guards the registration of thread caches, of all slab_resources
+std::mutex & cache_mutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+// set when the thread_caches of this thread are destroyed, a bool stays usable during the rest of the thread exit
+thread_local bool t_caches_destroyed = false;
+
+// the cache that this thread used last, checked before the thread_caches, which cost a guard on every access
+thread_local void * t_last_cache = nullptr;
+
+// the counters of a thread cache have one writer, so a load and a store instead of a read-modify-write,
+// release pairs with the acquire in stats()
+void add(std::atomic<std::uint64_t> & counter, std::uint64_t value)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_release);
+}
+
+// the link of a free block in a thread cache is stored in the block itself
+void * next_of(void * block)
+{
+    void * next;
+    std::memcpy(&next, block, sizeof(next));
+    return next;
+}
+
+void set_next(void * block, void * next)
+{
+    std::memcpy(block, &next, sizeof(next));
+}
+
+} // namespace
+
+struct slab_resource::thread_caches
+{
+    thread_caches() = default;
+    thread_caches(const thread_caches &) = delete;
+    thread_caches & operator=(const thread_caches &) = delete;
+
+    // returns the free blocks and the counters to the resources that still exist
+    ~thread_caches()
+    {
+        t_caches_destroyed = true;
+        t_last_cache = nullptr;
+        std::lock_guard<std::mutex> lock(cache_mutex());
+        for (auto cache : m_caches)
+        {
+            if (auto owner = cache->m_owner.load(std::memory_order_relaxed))
+            {
+                owner->remove_cache(*cache);
+            }
+            delete cache;
+        }
+    }
+
+    std::vector<thread_cache *> m_caches;
+};
+
+slab_resource::slab_resource(memory_resource * upstream) :
+    m_upstream(upstream != nullptr ? upstream : new_delete_resource())
+{
+    static_assert(sizeof(slab) == sizeof(std::uint32_t) && sizeof(link_t) == sizeof(std::uint32_t), "the links follow the slab header");
+    for (std::size_t index = 0; index < size_class_count; ++index)
+    {
+        auto & c = m_classes[index];
+        c.m_block_size = min_block_size << index;
+        c.m_block_shift = min_block_shift + index;
+        c.m_blocks = static_cast<std::uint32_t>(blocks_per_slab(c.m_block_size));
+        c.m_first_block = first_block_offset(c.m_block_size, c.m_blocks);
+    }
+    for (auto & chunk : m_slab_chunks)
+    {
+        chunk.store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+slab_resource::~slab_resource()
+{
+    {
+        // the threads delete their caches, the blocks in them go away with the slabs
+        std::lock_guard<std::mutex> lock(cache_mutex());
+        for (auto cache : m_caches)
+        {
+            cache->m_owner.store(nullptr, std::memory_order_release);
+        }
+    }
+
+    for (auto & chunk : m_slab_chunks)
+    {
+        auto slabs = chunk.load(std::memory_order_relaxed);
+        if (slabs == nullptr)
+        {
+            continue;
+        }
+        for (std::size_t i = 0; i < slab_chunk_size; ++i)
+        {
+            if (auto s = slabs[i].load(std::memory_order_relaxed))
+            {
+                m_upstream->deallocate(s, slab_size, slab_size);
+            }
+        }
+        delete[] slabs;
+    }
+}
+
+memory_resource * slab_resource::upstream() const
+{
+    return m_upstream;
+}
+
+memory_stats slab_resource::stats() const
+{
+    memory_stats stats;
+    stats.m_allocations = m_large.m_allocations.load(std::memory_order_relaxed);
+    stats.m_deallocations = m_large.m_deallocations.load(std::memory_order_relaxed);
+    stats.m_bytes_in_use = m_large.m_bytes_in_use.load(std::memory_order_relaxed);
+    stats.m_upstream_allocations = stats.m_allocations;
+    stats.m_upstream_bytes = stats.m_bytes_in_use;
+
+    std::lock_guard<std::mutex> lock(cache_mutex());
+    for (std::size_t index = 0; index < size_class_count; ++index)
+    {
+        auto sum = [this, index](std::atomic<std::uint64_t> class_counters::*counter) {
+            auto total = (m_removed[index].*counter).load(std::memory_order_acquire) +
+                         (m_shared_cache.m_counters[index].*counter).load(std::memory_order_acquire);
+            for (auto cache : m_caches)
+            {
+                total += (cache->m_counters[index].*counter).load(std::memory_order_acquire);
+            }
+            return total;
+        };
+
+        // a block is deallocated after it was allocated, reading the deallocations first keeps the difference positive
+        auto deallocated_bytes = sum(&class_counters::m_deallocated_bytes);
+        stats.m_deallocations += sum(&class_counters::m_deallocations);
+        auto allocated_bytes = sum(&class_counters::m_allocated_bytes);
+        stats.m_allocations += sum(&class_counters::m_allocations);
+        stats.m_bytes_in_use += allocated_bytes - deallocated_bytes;
+        auto slab_count = m_classes[index].m_slab_count.load(std::memory_order_relaxed);
+        stats.m_upstream_allocations += slab_count;
+        stats.m_upstream_bytes += slab_count * slab_size;
+    }
+    return stats;
+}
+
+std::size_t slab_resource::blocks_per_slab(std::size_t block_size)
+{
+    auto blocks = (slab_size - sizeof(slab)) / (block_size + sizeof(link_t));
+    while (first_block_offset(block_size, blocks) + blocks * block_size > slab_size)
+    {
+        --blocks;
+    }
+    return blocks;
+}
+
+std::size_t slab_resource::class_index(std::size_t bytes)
+{
+    std::size_t index = 0;
+    for (auto block_size = min_block_size; block_size < bytes && index < size_class_count; block_size *= 2)
+    {
+        ++index;
+    }
+    return index;
+}
+
+slab_resource::link_t * slab_resource::links(slab * s)
+{
+    return reinterpret_cast<link_t *>(s + 1);
+}
+
+char * slab_resource::block_address(const size_class & c, slab * s, std::uint32_t block)
+{
+    return reinterpret_cast<char *>(s) + c.m_first_block + (std::size_t(block) << c.m_block_shift);
+}
+
+slab_resource::slab * slab_resource::slab_of(void * block)
+{
+    return reinterpret_cast<slab *>(reinterpret_cast<std::uintptr_t>(block) & ~std::uintptr_t(slab_size - 1));
+}
+
+std::uint32_t slab_resource::block_index(const size_class & c, slab * s, void * block)
+{
+    auto offset = reinterpret_cast<std::uintptr_t>(block) - reinterpret_cast<std::uintptr_t>(s) - c.m_first_block;
+    return static_cast<std::uint32_t>(offset >> c.m_block_shift);
+}
+
+slab_resource::thread_cache * slab_resource::local_cache()
+{
+    auto cache = static_cast<thread_cache *>(t_last_cache);
+    if (cache != nullptr && cache->m_owner.load(std::memory_order_acquire) == this)
+    {
+        return cache;
+    }
+    return find_cache();
+}
+
+slab_resource::thread_cache * slab_resource::find_cache()
+{
+    if (t_caches_destroyed)
+    {
+        return nullptr;
+    }
+
+    static thread_local thread_caches caches;
+    for (auto cache : caches.m_caches)
+    {
+        if (cache->m_owner.load(std::memory_order_acquire) == this)
+        {
+            t_last_cache = cache;
+            return cache;
+        }
+    }
+
+    // the first use of this resource by this thread, also deletes the caches of the resources that were destroyed
+    std::lock_guard<std::mutex> lock(cache_mutex());
+    t_last_cache = nullptr;
+    auto kept = caches.m_caches.begin();
+    for (auto cache : caches.m_caches)
+    {
+        if (cache->m_owner.load(std::memory_order_relaxed) == nullptr)
+        {
+            delete cache;
+        }
+        else
+        {
+            *kept++ = cache;
+        }
+    }
+    caches.m_caches.erase(kept, caches.m_caches.end());
+
+    try
+    {
+        caches.m_caches.reserve(caches.m_caches.size() + 1);
+        m_caches.reserve(m_caches.size() + 1);
+        auto cache = new thread_cache;
+        cache->m_owner.store(this, std::memory_order_relaxed);
+        caches.m_caches.push_back(cache);
+        m_caches.push_back(cache);
+        t_last_cache = cache;
+        return cache;
+    }
+    catch (const std::bad_alloc &)
+    {
+        return nullptr;
+    }
+}
+
+// called under the cache mutex
+void slab_resource::remove_cache(thread_cache & cache)
+{
+    for (std::size_t index = 0; index < size_class_count; ++index)
+    {
+        auto & c = m_classes[index];
+        auto & local = cache.m_blocks[index];
+        while (local.m_count >= batch_size)
+        {
+            push_blocks(c, c.m_batches, local, batch_size);
+        }
+        while (local.m_count > 0)
+        {
+            push_blocks(c, c.m_singles, local, 1);
+        }
+
+        auto & counters = cache.m_counters[index];
+        auto & removed = m_removed[index];
+        add(removed.m_allocations, counters.m_allocations.load(std::memory_order_relaxed));
+        add(removed.m_allocated_bytes, counters.m_allocated_bytes.load(std::memory_order_relaxed));
+        add(removed.m_deallocations, counters.m_deallocations.load(std::memory_order_relaxed));
+        add(removed.m_deallocated_bytes, counters.m_deallocated_bytes.load(std::memory_order_relaxed));
+    }
+    m_caches.erase(std::find(m_caches.begin(), m_caches.end(), &cache));
+    cache.m_owner.store(nullptr, std::memory_order_release);
+}
+
+slab_resource::slab * slab_resource::find_slab(std::uint32_t number) const
+{
+    auto slabs = m_slab_chunks[number / slab_chunk_size].load(std::memory_order_acquire);
+    return slabs[number % slab_chunk_size].load(std::memory_order_acquire);
+}
+
+void slab_resource::add_slab(slab * s)
+{
+    auto number = m_slab_numbers.fetch_add(1);
+    if (number >= slab_chunk_size * max_slab_chunks)
+    {
+        m_slab_numbers.fetch_sub(1);
+        m_upstream->deallocate(s, slab_size, slab_size);
+        throw std::bad_alloc();
+    }
+
+    auto & chunk = m_slab_chunks[number / slab_chunk_size];
+    auto slabs = chunk.load(std::memory_order_acquire);
+    if (slabs == nullptr)
+    {
+        // another thread can create the same chunk concurrently, the first one to publish it wins
+        auto created = new std::atomic<slab *>[slab_chunk_size];
+        for (std::size_t i = 0; i < slab_chunk_size; ++i)
+        {
+            created[i].store(nullptr, std::memory_order_relaxed);
+        }
+        if (chunk.compare_exchange_strong(slabs, created, std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            slabs = created;
+        }
+        else
+        {
+            delete[] created;
+        }
+    }
+
+    s->m_number = number;
+    slabs[number % slab_chunk_size].store(s, std::memory_order_release);
+}
+
+// puts the first blocks of a new slab in front of @p local and shares the other batches, concurrent callers can each add a slab
+void slab_resource::allocate_slab(size_class & c, local_blocks & local)
+{
+    auto s = static_cast<slab *>(m_upstream->allocate(slab_size, slab_size));
+    add_slab(s);
+    c.m_slab_count.fetch_add(1, std::memory_order_relaxed);
+
+    auto first = block_address(c, s, 0);
+    auto block = first;
+    for (std::uint32_t i = 1; i < c.m_blocks; ++i)
+    {
+        set_next(block, block + c.m_block_size);
+        block += c.m_block_size;
+    }
+    set_next(block, local.m_head);
+
+    // one batch and the rest stay local, the other threads can take the shared batches from the start
+    auto shared = c.m_blocks / batch_size > 1 ? (c.m_blocks / batch_size - 1) * batch_size : 0;
+    auto kept = c.m_blocks - shared;
+    if (shared > 0)
+    {
+        auto slab_links = links(s);
+        auto first_id = (s->m_number << block_bits) | kept;
+        for (auto batch = kept; batch + batch_size < c.m_blocks; batch += batch_size)
+        {
+            slab_links[batch].store(first_id + (batch - kept) + batch_size + 1, std::memory_order_relaxed);
+        }
+        push_linked(c.m_batches, first_id, slab_links[c.m_blocks - batch_size]);
+        set_next(block_address(c, s, kept - 1), local.m_head);
+    }
+    local.m_head = first;
+    local.m_count += kept;
+}
+
+// takes the blocks on top of @p stack, @p count of them, into the empty @p local
+bool slab_resource::pop_blocks(const size_class & c, std::atomic<std::uint64_t> & stack, local_blocks & local, std::uint32_t count)
+{
+    auto head = stack.load(std::memory_order_acquire);
+    while (static_cast<std::uint32_t>(head) != 0)
+    {
+        auto id = static_cast<std::uint32_t>(head) - 1;
+        auto s = find_slab(id >> block_bits);
+        // when another thread took the blocks in the meantime the link is stale, but then the tag changed
+        auto next = links(s)[id & block_mask].load(std::memory_order_relaxed);
+        auto tag = (head >> 32) + 1;
+        if (stack.compare_exchange_weak(head, (tag << 32) | next, std::memory_order_acquire, std::memory_order_acquire))
+        {
+            local.m_head = block_address(c, s, id & block_mask);
+            local.m_count = count;
+            return true;
+        }
+    }
+    return false;
+}
+
+// moves the first @p count blocks of @p local onto @p stack, they stay linked through their first bytes
+void slab_resource::push_blocks(const size_class & c, std::atomic<std::uint64_t> & stack, local_blocks & local, std::uint32_t count)
+{
+    auto first = local.m_head;
+    auto last = first;
+    for (std::uint32_t i = 1; i < count; ++i)
+    {
+        last = next_of(last);
+    }
+    local.m_head = next_of(last);
+    local.m_count -= count;
+
+    auto s = slab_of(first);
+    auto block = block_index(c, s, first);
+    push_linked(stack, (s->m_number << block_bits) | block, links(s)[block]);
+}
+
+// pushes the batches that are linked from the one with @p first_id to the one with @p last_link
+void slab_resource::push_linked(std::atomic<std::uint64_t> & stack, std::uint32_t first_id, link_t & last_link)
+{
+    auto head = stack.load(std::memory_order_relaxed);
+    do
+    {
+        last_link.store(static_cast<std::uint32_t>(head), std::memory_order_relaxed);
+    } while (!stack.compare_exchange_weak(head, (((head >> 32) + 1) << 32) | (first_id + 1), std::memory_order_release, std::memory_order_relaxed));
+}
+
+void * slab_resource::allocate_block(std::size_t index, thread_cache & cache, std::size_t bytes)
+{
+    auto & c = m_classes[index];
+    auto & local = cache.m_blocks[index];
+    if (local.m_count == 0 && !pop_blocks(c, c.m_batches, local, batch_size) && !pop_blocks(c, c.m_singles, local, 1))
+    {
+        allocate_slab(c, local);
+    }
+
+    auto block = local.m_head;
+    local.m_head = next_of(block);
+    --local.m_count;
+
+    // the counters only change once the block was obtained, allocate_slab() can throw
+    auto & counters = cache.m_counters[index];
+    add(counters.m_allocations, 1);
+    add(counters.m_allocated_bytes, bytes);
+    return block;
+}
+
+void slab_resource::deallocate_block(std::size_t index, thread_cache & cache, void * p, std::size_t bytes)
+{
+    auto & local = cache.m_blocks[index];
+    set_next(p, local.m_head);
+    local.m_head = p;
+    ++local.m_count;
+
+    auto & counters = cache.m_counters[index];
+    add(counters.m_deallocations, 1);
+    add(counters.m_deallocated_bytes, bytes);
+
+    // the other threads take the blocks back in batches, the executor thread deallocates what the producers allocated
+    if (local.m_count >= 2 * batch_size)
+    {
+        push_blocks(m_classes[index], m_classes[index].m_batches, local, batch_size);
+    }
+}
+
+void * slab_resource::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    auto index = class_index(bytes);
+    if (index == size_class_count || alignment > alignof(std::max_align_t))
+    {
+        auto p = m_upstream->allocate(bytes, alignment);
+        ++m_large.m_allocations;
+        m_large.m_bytes_in_use += bytes;
+        return p;
+    }
+
+    if (auto cache = local_cache())
+    {
+        return allocate_block(index, *cache, bytes);
+    }
+    std::lock_guard<std::mutex> lock(m_shared_mutex);
+    return allocate_block(index, m_shared_cache, bytes);
+}
+
+void slab_resource::do_deallocate(void * p, std::size_t bytes, std::size_t alignment)
+{
+    auto index = class_index(bytes);
+    if (index == size_class_count || alignment > alignof(std::max_align_t))
+    {
+        m_upstream->deallocate(p, bytes, alignment);
+        ++m_large.m_deallocations;
+        m_large.m_bytes_in_use -= bytes;
+        return;
+    }
+
+    if (auto cache = local_cache())
+    {
+        deallocate_block(index, *cache, p, bytes);
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_shared_mutex);
+    deallocate_block(index, m_shared_cache, p, bytes);
+}
+
+bool slab_resource::do_is_equal(const memory_resource & other) const noexcept
+{
+    return this == &other;
+}
+
+} // namespace venus
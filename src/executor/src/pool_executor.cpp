@@ -0,0 +1,255 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#include "executor/pool_executor.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <string>
+#include <utility>
+
+namespace venus {
+
+namespace {
+
+// identifies the pool and worker the current thread belongs to, if any.
+thread_local const pool_executor * t_pool = nullptr;
+thread_local std::size_t t_worker_index = 0;
+
+std::uint32_t next_random(std::uint32_t & state)
+{
+    // xorshift32, good enough to spread the victim selection
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+} // namespace
+
+pool_executor::pool_executor(std::size_t thread_count) :
+    pool_executor(pool_options{thread_count, thread_options(), {}})
+{
+}
+
+pool_executor::pool_executor(const pool_options & options)
+{
+    auto thread_count = options.m_thread_count;
+    if (thread_count == 0)
+    {
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    m_workers.reserve(thread_count);
+    for (std::size_t i = 0; i < thread_count; ++i)
+    {
+        m_workers.emplace_back(new worker());
+        m_workers.back()->m_random_state = static_cast<std::uint32_t>(i + 1) * 2654435761u;
+    }
+
+    // threads are only started when all workers exist, since any of them can be a victim
+    try
+    {
+        for (std::size_t i = 0; i < thread_count; ++i)
+        {
+            auto worker_options = options.m_thread;
+            if (!worker_options.m_name.empty())
+            {
+                worker_options.m_name += "-" + std::to_string(i);
+            }
+            if (!options.m_worker_cpus.empty())
+            {
+                worker_options.m_cpus = {options.m_worker_cpus[i % options.m_worker_cpus.size()]};
+            }
+            m_workers[i]->m_thread = start_thread(worker_options, [this, i] { run(i); });
+        }
+    }
+    catch (...)
+    {
+        stop();
+        throw;
+    }
+}
+
+pool_executor::~pool_executor()
+{
+    stop();
+}
+
+void pool_executor::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_end = true;
+    }
+    m_condition.notify_all();
+
+    for (auto & pool_worker : m_workers)
+    {
+        if (pool_worker->m_thread.joinable())
+        {
+            pool_worker->m_thread.join();
+        }
+    }
+}
+
+bool pool_executor::is_pool_thread() const
+{
+    return t_pool == this;
+}
+
+std::size_t pool_executor::thread_count() const
+{
+    return m_workers.size();
+}
+
+void pool_executor::add(function_t function)
+{
+    // counted before the task is published, so a worker that takes it never sees m_pending drop below zero
+    ++m_pending;
+    try
+    {
+        if (is_pool_thread())
+        {
+            auto & self = *m_workers[t_worker_index];
+            std::lock_guard<std::mutex> lock(self.m_mutex);
+            self.m_tasks.push_back(std::move(function));
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_injection_queue.push_back(std::move(function));
+        }
+    }
+    catch (...)
+    {
+        --m_pending;
+        throw;
+    }
+    notify_one();
+}
+
+void pool_executor::notify_one()
+{
+    // m_pending is incremented before m_sleeping is read, a worker that is about to sleep increments
+    // m_sleeping before it reads m_pending, so at least one of the two sides observes the other.
+    if (m_sleeping == 0)
+    {
+        return;
+    }
+
+    // taking the lock ensures the sleeping worker is either waiting or has not evaluated its predicate yet
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+    }
+    m_condition.notify_one();
+}
+
+void pool_executor::run(std::size_t index)
+{
+    t_pool = this;
+    t_worker_index = index;
+
+    function_t task;
+    for (;;)
+    {
+        if (try_pop(index, task))
+        {
+            try
+            {
+                task();
+            }
+            catch (std::exception &)
+            {
+                // exceptions are ignored, like on venus::executor
+            }
+            catch (...)
+            {
+            }
+            task = nullptr;
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_end && m_pending == 0)
+        {
+            return;
+        }
+
+        ++m_sleeping;
+        m_condition.wait(lock, [this] { return m_end || m_pending != 0; });
+        --m_sleeping;
+    }
+}
+
+bool pool_executor::try_pop(std::size_t index, function_t & task)
+{
+    if (try_pop_local(*m_workers[index], task) || try_pop_global(task) || try_steal(index, task))
+    {
+        --m_pending;
+        return true;
+    }
+    return false;
+}
+
+bool pool_executor::try_pop_local(worker & self, function_t & task)
+{
+    std::lock_guard<std::mutex> lock(self.m_mutex);
+    if (self.m_tasks.empty())
+    {
+        return false;
+    }
+
+    // newest first, its data is most likely still in cache
+    task = std::move(self.m_tasks.back());
+    self.m_tasks.pop_back();
+    return true;
+}
+
+bool pool_executor::try_pop_global(function_t & task)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_injection_queue.empty())
+    {
+        return false;
+    }
+
+    task = std::move(m_injection_queue.front());
+    m_injection_queue.pop_front();
+    return true;
+}
+
+bool pool_executor::try_steal(std::size_t index, function_t & task)
+{
+    const auto count = m_workers.size();
+    if (count < 2)
+    {
+        return false;
+    }
+
+    // start at a random victim, then try all other workers once
+    auto & self = *m_workers[index];
+    const auto start = next_random(self.m_random_state) % count;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const auto victim_index = (start + i) % count;
+        if (victim_index == index)
+        {
+            continue;
+        }
+
+        auto & victim = *m_workers[victim_index];
+        std::lock_guard<std::mutex> lock(victim.m_mutex);
+        if (!victim.m_tasks.empty())
+        {
+            // oldest first, leaves the victim the work it touched most recently
+            task = std::move(victim.m_tasks.front());
+            victim.m_tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace venus
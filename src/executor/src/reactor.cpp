@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#include "executor/reactor.hpp"
+
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <exception>
+#include <system_error>
+#include <utility>
+
+#if defined(__linux__)
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#endif
+
+namespace venus {
+
+namespace {
+
+[[noreturn]] void throw_system_error(int error, const char * what)
+{
+    throw std::system_error(error, std::generic_category(), what);
+}
+
+} // namespace
+
+#if defined(__linux__)
+
+namespace {
+
+// the number of events taken from the kernel per epoll_wait
+constexpr std::size_t max_events = 64;
+
+void add_to_epoll(int epoll, int fd)
+{
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    if (epoll_ctl(epoll, EPOLL_CTL_ADD, fd, &event) != 0)
+    {
+        throw_system_error(errno, "epoll_ctl");
+    }
+}
+
+void drain(int fd)
+{
+    std::uint64_t count = 0;
+    while (read(fd, &count, sizeof(count)) < 0 && errno == EINTR)
+    {
+    }
+}
+
+} // namespace
+
+reactor::reactor(spin_policy spin) :
+    m_spin(spin)
+{
+    try
+    {
+        m_epoll = epoll_create1(EPOLL_CLOEXEC);
+        if (m_epoll < 0)
+        {
+            throw_system_error(errno, "epoll_create1");
+        }
+        m_event = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (m_event < 0)
+        {
+            throw_system_error(errno, "eventfd");
+        }
+        m_timer = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (m_timer < 0)
+        {
+            throw_system_error(errno, "timerfd_create");
+        }
+        add_to_epoll(m_epoll, m_event);
+        add_to_epoll(m_epoll, m_timer);
+    }
+    catch (...)
+    {
+        close_all();
+        throw;
+    }
+}
+
+reactor::~reactor()
+{
+    close_all();
+}
+
+void reactor::close_all()
+{
+    for (auto fd : {m_timer, m_event, m_epoll})
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+    }
+}
+
+void reactor::watch(int fd, std::uint32_t events, callback_t callback)
+{
+    epoll_event event = {};
+    event.events = events;
+    event.data.fd = fd;
+
+    auto it = m_callbacks.find(fd);
+    if (epoll_ctl(m_epoll, it == m_callbacks.end() ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, fd, &event) != 0)
+    {
+        throw_system_error(errno, "epoll_ctl");
+    }
+    m_callbacks[fd] = std::make_shared<callback_t>(std::move(callback));
+}
+
+void reactor::unwatch(int fd)
+{
+    if (m_callbacks.erase(fd) != 0)
+    {
+        // fails for an fd that was closed already, the kernel removed it from the epoll set then
+        epoll_ctl(m_epoll, EPOLL_CTL_DEL, fd, nullptr);
+    }
+}
+
+std::size_t reactor::poll()
+{
+    return dispatch(0);
+}
+
+void reactor::wake()
+{
+    if (!m_sleeping.load())
+    {
+        return;
+    }
+
+    std::uint64_t one = 1;
+    while (write(m_event, &one, sizeof(one)) < 0 && errno == EINTR)
+    {
+    }
+}
+
+void reactor::block(time_point_t deadline)
+{
+    if (deadline != time_point_t::max())
+    {
+        arm_timer(deadline);
+    }
+    dispatch(-1);
+}
+
+std::size_t reactor::dispatch(int timeout_ms)
+{
+    std::array<epoll_event, max_events> events;
+    auto count = epoll_wait(m_epoll, events.data(), static_cast<int>(events.size()), timeout_ms);
+
+    // callbacks that add work for the consumer need not write to the eventfd
+    m_sleeping.store(false);
+    if (count < 0)
+    {
+        if (errno == EINTR)
+        {
+            return 0;
+        }
+        throw_system_error(errno, "epoll_wait");
+    }
+
+    std::size_t called = 0;
+    for (std::size_t i = 0; i < static_cast<std::size_t>(count); ++i)
+    {
+        auto fd = events[i].data.fd;
+        if (fd == m_event)
+        {
+            drain(m_event);
+            continue;
+        }
+        if (fd == m_timer)
+        {
+            drain(m_timer);
+            m_armed = time_point_t::max();
+            continue;
+        }
+
+        // an earlier callback of this batch can have unwatched the fd
+        auto it = m_callbacks.find(fd);
+        if (it == m_callbacks.end())
+        {
+            continue;
+        }
+        auto callback = it->second;
+        try
+        {
+            (*callback)(events[i].events);
+        }
+        catch (std::exception &)
+        {
+            // exceptions are ignored, like those of tasks on venus::executor
+        }
+        catch (...)
+        {
+        }
+        ++called;
+    }
+    return called;
+}
+
+void reactor::arm_timer(time_point_t deadline)
+{
+    if (deadline == m_armed)
+    {
+        return;
+    }
+
+    // steady_clock is CLOCK_MONOTONIC on Linux, a zero it_value would disarm the timer
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+    ns = ns > 0 ? ns : 1;
+    itimerspec spec = {};
+    spec.it_value.tv_sec = static_cast<time_t>(ns / 1000000000);
+    spec.it_value.tv_nsec = static_cast<long>(ns % 1000000000);
+    if (timerfd_settime(m_timer, TFD_TIMER_ABSTIME, &spec, nullptr) != 0)
+    {
+        throw_system_error(errno, "timerfd_settime");
+    }
+    m_armed = deadline;
+}
+
+#else
+
+reactor::reactor(spin_policy spin) :
+    m_spin(spin)
+{
+    throw_system_error(static_cast<int>(std::errc::function_not_supported), "reactor");
+}
+
+reactor::~reactor() = default;
+
+void reactor::close_all()
+{
+}
+
+void reactor::watch(int, std::uint32_t, callback_t)
+{
+}
+
+void reactor::unwatch(int)
+{
+}
+
+std::size_t reactor::poll()
+{
+    return 0;
+}
+
+void reactor::wake()
+{
+}
+
+void reactor::block(time_point_t)
+{
+}
+
+std::size_t reactor::dispatch(int)
+{
+    return 0;
+}
+
+void reactor::arm_timer(time_point_t)
+{
+}
+
+#endif
+
+std::size_t reactor::watched_count() const
+{
+    return m_callbacks.size();
+}
+
+} // namespace venus
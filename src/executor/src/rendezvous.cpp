@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#include "executor/rendezvous.hpp"
+#include "executor/spin_wait.hpp"
+
+#include <thread>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#endif
+
+namespace venus {
+namespace detail {
+
+constexpr std::uint32_t event::empty;
+constexpr std::uint32_t event::sleeping;
+constexpr std::uint32_t event::ready;
+
+namespace {
+
+// on a single cpu the thread that sets the event cannot run while the waiter spins
+const spin_policy & waiter_spin()
+{
+    static const spin_policy policy = std::thread::hardware_concurrency() > 1 ? spin_policy() : spin_policy{0, 0};
+    return policy;
+}
+
+} // namespace
+
+#if defined(__linux__)
+
+namespace {
+
+// std::atomic<std::uint32_t> has the size and representation of the uint32_t, so the kernel can wait on it
+int futex(std::atomic<std::uint32_t> * state, int operation, std::uint32_t value)
+{
+    return static_cast<int>(syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(state), operation, value, nullptr, nullptr, 0));
+}
+
+} // namespace
+
+void event::sleep() noexcept
+{
+    if (spin_until(waiter_spin(), [this] { return m_state.load(std::memory_order_acquire) == ready; }))
+    {
+        return;
+    }
+
+    auto expected = empty;
+    if (!m_state.compare_exchange_strong(expected, sleeping))
+    {
+        return; // ready
+    }
+
+    // returns right away when set() changed the state in the meantime, a wake-up can also be spurious
+    while (m_state.load() != ready)
+    {
+        futex(&m_state, FUTEX_WAIT_PRIVATE, sleeping);
+    }
+}
+
+void event::wake(std::atomic<std::uint32_t> * state) noexcept
+{
+    futex(state, FUTEX_WAKE_PRIVATE, 1);
+}
+
+#else
+
+namespace {
+
+// waiters sleep on the condition variable their address hashes to, like std::atomic<T>::wait()
+struct waiter_slot
+{
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+};
+
+waiter_slot & slot_of(const void * address)
+{
+    static std::array<waiter_slot, 16> slots;
+    return slots[std::hash<const void *>()(address) % slots.size()];
+}
+
+} // namespace
+
+void event::sleep() noexcept
+{
+    if (spin_until(waiter_spin(), [this] { return m_state.load(std::memory_order_acquire) == ready; }))
+    {
+        return;
+    }
+
+    auto expected = empty;
+    if (!m_state.compare_exchange_strong(expected, sleeping))
+    {
+        return; // ready
+    }
+
+    auto & slot = slot_of(&m_state);
+    std::unique_lock<std::mutex> lock(slot.m_mutex);
+    slot.m_condition.wait(lock, [this] { return m_state.load() == ready; });
+}
+
+void event::wake(std::atomic<std::uint32_t> * state) noexcept
+{
+    auto & slot = slot_of(state);
+    {
+        std::lock_guard<std::mutex> lock(slot.m_mutex);
+    }
+    slot.m_condition.notify_all();
+}
+
+#endif
+
+} // namespace detail
+} // namespace venus
@@ -7,13 +7,85 @@
 #include <algorithm>
 #include <cassert>
 #include <chrono>
+#include <utility>
 
 namespace venus {
 
+constexpr std::chrono::nanoseconds scheduled_calls::tick_duration;
+constexpr std::size_t scheduled_calls::slots_per_level;
+constexpr std::size_t scheduled_calls::levels;
+constexpr scheduled_calls::index_t scheduled_calls::npos;
+constexpr std::uint8_t scheduled_calls::ready_level;
+
+namespace {
+
+constexpr std::size_t slot_bits = 6;
+constexpr std::uint64_t slot_mask = scheduled_calls::slots_per_level - 1;
+static_assert(std::uint64_t(1) << slot_bits == scheduled_calls::slots_per_level, "slots_per_level must match slot_bits");
+
+std::uint64_t to_tick(time_point_t at)
+{
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(at.time_since_epoch()).count();
+    if (ns < 0)
+    {
+        return 0;
+    }
+    return static_cast<std::uint64_t>(ns) / static_cast<std::uint64_t>(scheduled_calls::tick_duration.count());
+}
+
+std::size_t highest_bit(std::uint64_t value)
+{
+    return static_cast<std::size_t>(63 - __builtin_clzll(value));
+}
+
+std::size_t lowest_bit(std::uint64_t value)
+{
+    return static_cast<std::size_t>(__builtin_ctzll(value));
+}
+
+} // namespace
+
+time_point_t coalesce(time_point_t at, duration_t slack)
+{
+    auto slack_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(slack).count();
+    if (slack_ns <= 1)
+    {
+        return at;
+    }
+
+    auto power_of_two = std::chrono::nanoseconds(std::int64_t(1) << highest_bit(static_cast<std::uint64_t>(slack_ns)));
+    auto granularity = std::chrono::duration_cast<duration_t>(power_of_two);
+    if (granularity <= duration_t(1) || at > time_point_t::max() - granularity)
+    {
+        return at;
+    }
+
+    auto remainder = at.time_since_epoch() % granularity;
+    if (remainder == duration_t::zero())
+    {
+        return at;
+    }
+    // for a negative time_since_epoch the remainder is negative, and subtracting it rounds up as well
+    return remainder > duration_t::zero() ? at + (granularity - remainder) : at - remainder;
+}
+
+call_t::call_t() :
+    m_id(0),
+    m_at(),
+    m_repeat_interval(duration_t::zero()),
+    m_slack(duration_t::zero()),
+    m_missed_policy(missed_tick_policy::catch_up),
+    m_missed(0)
+{
+}
+
 call_t::call_t(call_t::id_t id, time_point_t at, function_t function) :
     m_id(id),
     m_at(at),
     m_repeat_interval(duration_t::zero()),
+    m_slack(duration_t::zero()),
+    m_missed_policy(missed_tick_policy::catch_up),
+    m_missed(0),
     m_function(std::move(function))
 {
 }
@@ -22,46 +94,431 @@ call_t::call_t(call_t::id_t id, time_point_t at, duration_t interval, function_t
     m_id(id),
     m_at(at),
     m_repeat_interval(interval),
+    m_slack(duration_t::zero()),
+    m_missed_policy(missed_tick_policy::catch_up),
+    m_missed(0),
     m_function(std::move(function))
 {
 }
 
+call_t::call_t(call_t::id_t id, time_point_t at, duration_t interval, duration_t slack, function_t function) :
+    m_id(id),
+    m_at(at),
+    m_repeat_interval(interval),
+    m_slack(slack),
+    m_missed_policy(missed_tick_policy::catch_up),
+    m_missed(0),
+    m_function(std::move(function))
+{
+}
+
+time_point_t call_t::due() const
+{
+    return coalesce(m_at, m_slack);
+}
+
+scheduled_calls::scheduled_calls(memory_resource * resource) :
+    m_nodes(resource),
+    m_calls(resource),
+    m_free(resource),
+    m_index(resource),
+    m_ready(resource)
+{
+    for (auto & level : m_slots)
+    {
+        level.fill(npos);
+    }
+}
+
 bool scheduled_calls::empty() const
 {
-    return m_calls.empty();
+    return m_size == 0;
+}
+
+std::size_t scheduled_calls::size() const
+{
+    return m_size;
+}
+
+scheduled_calls::indexed * scheduled_calls::find(call_t::id_t id)
+{
+    if (m_index.empty())
+    {
+        return nullptr;
+    }
+
+    auto mask = m_index.size() - 1;
+    for (auto slot = home_slot(id); m_index[slot].m_entry != npos; slot = (slot + 1) & mask)
+    {
+        if (m_index[slot].m_id == id)
+        {
+            return &m_index[slot];
+        }
+    }
+    return nullptr;
+}
+
+std::size_t scheduled_calls::home_slot(call_t::id_t id) const
+{
+    // fibonacci hashing, sequential ids and ids that only differ in their high bits are spread over the table
+    auto hash = id * 0x9E3779B97F4A7C15ull;
+    return static_cast<std::size_t>(hash ^ (hash >> 32)) & (m_index.size() - 1);
+}
+
+void scheduled_calls::add_index(call_t::id_t id, index_t entry)
+{
+    auto mask = m_index.size() - 1;
+    auto slot = home_slot(id);
+    while (m_index[slot].m_entry != npos)
+    {
+        slot = (slot + 1) & mask;
+    }
+    m_index[slot].m_id = id;
+    m_index[slot].m_entry = entry;
+}
+
+// removes the slot of @p entry and moves the following slots of the probe sequence back, so no tombstones are needed
+void scheduled_calls::erase_index(call_t::id_t id, index_t entry)
+{
+    auto mask = m_index.size() - 1;
+    auto slot = home_slot(id);
+    while (m_index[slot].m_entry != entry)
+    {
+        assert(m_index[slot].m_entry != npos);
+        slot = (slot + 1) & mask;
+    }
+
+    for (auto next = (slot + 1) & mask; m_index[next].m_entry != npos; next = (next + 1) & mask)
+    {
+        // the entry at 'next' can fill the hole when its home slot is not in (slot, next], cyclically
+        auto home = home_slot(m_index[next].m_id);
+        if (((next - home) & mask) >= ((next - slot) & mask))
+        {
+            m_index[slot] = m_index[next];
+            slot = next;
+        }
+    }
+    m_index[slot].m_entry = npos;
+}
+
+void scheduled_calls::grow_index()
+{
+    vector_t<indexed> previous(std::max<std::size_t>(16, m_index.size() * 2), m_index.get_allocator());
+    previous.swap(m_index);
+    auto mask = m_index.size() - 1;
+    for (auto & moved : previous)
+    {
+        if (moved.m_entry != npos)
+        {
+            auto slot = home_slot(moved.m_id);
+            while (m_index[slot].m_entry != npos)
+            {
+                slot = (slot + 1) & mask;
+            }
+            m_index[slot] = moved;
+        }
+    }
 }
 
-// calls are added in-order, ordered from first to last in time
 void scheduled_calls::insert(call_t && call)
 {
-    auto it = std::lower_bound(m_calls.begin(), m_calls.end(), call, [](const call_t & a, const call_t & b) { return a.m_at > b.m_at; });
-    m_calls.insert(it, call);
+    if ((m_size + 1) * 2 > m_index.size())
+    {
+        grow_index();
+    }
+
+    auto id = call.m_id;
+    auto index = allocate(std::move(call));
+    add_index(id, index);
+    ++m_size;
+
+    auto & inserted = m_nodes[index];
+    if (m_deadline_valid && inserted.m_due < m_deadline)
+    {
+        m_deadline = inserted.m_due;
+    }
+    place(index);
+}
+
+bool scheduled_calls::remove(call_t::id_t id)
+{
+    auto found = find(id);
+    if (found == nullptr)
+    {
+        return false;
+    }
+
+    auto index = found->m_entry;
+    erase_index(id, index);
+    --m_size;
+    unlink(index);
+    release(index);
+    m_deadline_valid = false;
+    return true;
 }
 
-void scheduled_calls::remove(call_t::id_t id)
+std::vector<call_t::id_t> scheduled_calls::remove_if(const std::function<bool(const call_t &)> & predicate)
 {
-    auto it = std::find_if(m_calls.begin(), m_calls.end(), [id](const call_t & call) { return call.m_id == id; });
-    if (it != m_calls.end())
+    std::vector<call_t::id_t> removed;
+    for (auto & slot : m_index)
     {
-        m_calls.erase(it);
+        if (slot.m_entry != npos && predicate(m_calls[slot.m_entry]))
+        {
+            removed.push_back(slot.m_id);
+        }
     }
+
+    for (auto id : removed)
+    {
+        remove(id);
+    }
+    return removed;
 }
 
 time_point_t scheduled_calls::next_deadline() const
 {
-    assert(!m_calls.empty());
-    return m_calls.back().m_at;
+    assert(!empty());
+    if (!m_ready.empty())
+    {
+        return m_nodes[m_ready.front()].m_due;
+    }
+
+    if (!m_deadline_valid)
+    {
+        // the lowest occupied slot of the lowest occupied level holds the earliest deadline
+        std::size_t level = 0;
+        while (m_occupied[level] == 0)
+        {
+            ++level;
+        }
+
+        auto index = m_slots[level][lowest_bit(m_occupied[level])];
+        m_deadline = m_nodes[index].m_due;
+        for (; index != npos; index = m_nodes[index].m_next)
+        {
+            m_deadline = std::min(m_deadline, m_nodes[index].m_due);
+        }
+        m_deadline_valid = true;
+    }
+    return m_deadline;
 }
 
 call_t scheduled_calls::pop_and_reschedule()
 {
-    call_t call(std::move(m_calls.back()));
-    m_calls.pop_back();
+    assert(!empty());
+    if (m_ready.empty())
+    {
+        cascade();
+    }
+
+    auto index = pop_ready();
+    m_deadline_valid = false;
+
+    auto & first = m_calls[index];
+    call_t call(std::move(first));
     if (call.m_repeat_interval != duration_t::zero())
     {
-        insert(call_t(call.m_id, call.m_at + call.m_repeat_interval, call.m_repeat_interval, call.m_function));
+        // the entry is re-used, it keeps its place in m_index
+        first = call_t(call.m_id, call.m_at + call.m_repeat_interval, call.m_repeat_interval, call.m_slack, function_t());
+        first.m_missed_policy = call.m_missed_policy;
+        auto & rescheduled = m_nodes[index];
+        rescheduled.m_due = first.due();
+        rescheduled.m_sequence = m_sequence++;
+        rescheduled.m_tick = to_tick(rescheduled.m_due);
+        place(index);
+    }
+    else
+    {
+        erase_index(call.m_id, index);
+        --m_size;
+        release(index);
     }
     return call;
 }
 
+void scheduled_calls::restore(call_t && call, time_point_t now)
+{
+    auto found = find(call.m_id);
+    if (found == nullptr)
+    {
+        return;
+    }
+
+    auto index = found->m_entry;
+    auto & restored = m_calls[index];
+    restored.m_function = std::move(call.m_function);
+    if (restored.m_missed_policy == missed_tick_policy::catch_up || restored.m_at > now)
+    {
+        return;
+    }
+
+    // the ticks in [m_at, now] are missed, skip moves past all of them, coalesce keeps the last one to run it right away
+    auto missed = static_cast<std::size_t>((now - restored.m_at) / restored.m_repeat_interval) + 1;
+    if (restored.m_missed_policy == missed_tick_policy::coalesce)
+    {
+        --missed;
+    }
+    if (missed == 0)
+    {
+        return;
+    }
+
+    unlink(index);
+    restored.m_at += restored.m_repeat_interval * static_cast<duration_t::rep>(missed);
+    restored.m_missed = missed;
+    auto & rescheduled = m_nodes[index];
+    rescheduled.m_due = restored.due();
+    rescheduled.m_tick = to_tick(rescheduled.m_due);
+    m_deadline_valid = false;
+    place(index);
+}
+
+scheduled_calls::index_t scheduled_calls::allocate(call_t && call)
+{
+    index_t index;
+    if (m_free.empty())
+    {
+        index = static_cast<index_t>(m_calls.size());
+        m_calls.push_back(std::move(call));
+        m_nodes.emplace_back();
+    }
+    else
+    {
+        index = m_free.back();
+        m_free.pop_back();
+        m_calls[index] = std::move(call);
+    }
+
+    auto & allocated = m_nodes[index];
+    allocated.m_due = m_calls[index].due();
+    allocated.m_sequence = m_sequence++;
+    allocated.m_tick = to_tick(allocated.m_due);
+    return index;
+}
+
+void scheduled_calls::release(index_t index)
+{
+    // destroy the function now, the entry itself is re-used by a later insert()
+    m_calls[index].m_function = nullptr;
+    m_free.push_back(index);
+}
+
+// stores the entry in m_ready if it is due at the current tick,
+// otherwise in the wheel at the lowest level where its tick differs from the current tick.
+void scheduled_calls::place(index_t index)
+{
+    auto & placed = m_nodes[index];
+    if (placed.m_tick <= m_current_tick)
+    {
+        push_ready(index);
+        return;
+    }
+
+    auto level = highest_bit(placed.m_tick ^ m_current_tick) / slot_bits;
+    auto slot = (placed.m_tick >> (level * slot_bits)) & slot_mask;
+    assert(level < levels);
+
+    placed.m_level = static_cast<std::uint8_t>(level);
+    placed.m_slot = static_cast<std::uint8_t>(slot);
+    placed.m_previous = npos;
+    placed.m_next = m_slots[level][slot];
+    if (placed.m_next != npos)
+    {
+        m_nodes[placed.m_next].m_previous = index;
+    }
+    m_slots[level][slot] = index;
+    m_occupied[level] |= std::uint64_t(1) << slot;
+}
+
+void scheduled_calls::unlink(index_t index)
+{
+    auto & unlinked = m_nodes[index];
+    if (unlinked.m_level == ready_level)
+    {
+        remove_ready(index);
+        return;
+    }
+
+    if (unlinked.m_next != npos)
+    {
+        m_nodes[unlinked.m_next].m_previous = unlinked.m_previous;
+    }
+
+    if (unlinked.m_previous != npos)
+    {
+        m_nodes[unlinked.m_previous].m_next = unlinked.m_next;
+    }
+    else
+    {
+        auto & head = m_slots[unlinked.m_level][unlinked.m_slot];
+        head = unlinked.m_next;
+        if (head == npos)
+        {
+            m_occupied[unlinked.m_level] &= ~(std::uint64_t(1) << unlinked.m_slot);
+        }
+    }
+}
+
+// moves the current tick forward to the first occupied slot and re-places its entries,
+// until at least one entry is due at the current tick.
+void scheduled_calls::cascade()
+{
+    m_deadline_valid = false;
+    while (m_ready.empty())
+    {
+        std::size_t level = 0;
+        while (m_occupied[level] == 0)
+        {
+            ++level;
+            assert(level < levels);
+        }
+
+        auto slot = lowest_bit(m_occupied[level]);
+        auto shift = level * slot_bits;
+        m_current_tick = ((m_current_tick >> (shift + slot_bits)) << (shift + slot_bits)) | (std::uint64_t(slot) << shift);
+
+        auto index = m_slots[level][slot];
+        m_slots[level][slot] = npos;
+        m_occupied[level] &= ~(std::uint64_t(1) << slot);
+        while (index != npos)
+        {
+            auto next = m_nodes[index].m_next;
+            place(index);
+            index = next;
+        }
+    }
+}
+
+bool scheduled_calls::earlier(index_t a, index_t b) const
+{
+    const auto & lhs = m_nodes[a];
+    const auto & rhs = m_nodes[b];
+    return lhs.m_due < rhs.m_due || (lhs.m_due == rhs.m_due && lhs.m_sequence < rhs.m_sequence);
+}
+
+void scheduled_calls::push_ready(index_t index)
+{
+    m_nodes[index].m_level = ready_level;
+    m_ready.push_back(index);
+    std::push_heap(m_ready.begin(), m_ready.end(), [this](index_t a, index_t b) { return earlier(b, a); });
+}
+
+scheduled_calls::index_t scheduled_calls::pop_ready()
+{
+    std::pop_heap(m_ready.begin(), m_ready.end(), [this](index_t a, index_t b) { return earlier(b, a); });
+    auto index = m_ready.back();
+    m_ready.pop_back();
+    return index;
+}
+
+// m_ready only holds the entries of a single tick (and entries inserted with a deadline in the past), so it is small.
+void scheduled_calls::remove_ready(index_t index)
+{
+    auto it = std::find(m_ready.begin(), m_ready.end(), index);
+    assert(it != m_ready.end());
+    *it = m_ready.back();
+    m_ready.pop_back();
+    std::make_heap(m_ready.begin(), m_ready.end(), [this](index_t a, index_t b) { return earlier(b, a); });
+}
+
 } // namespace venus
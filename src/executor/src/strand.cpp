@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#include "executor/strand.hpp"
+
+#include <thread>
+#include <utility>
+
+namespace venus {
+
+namespace {
+
+thread_local const strand * t_strand = nullptr;
+
+} // namespace
+
+constexpr std::size_t strand::batch_size;
+
+strand::strand(pool_executor & pool) :
+    m_pool(pool)
+{
+}
+
+strand::~strand()
+{
+    assert(!is_current_strand() && "destroying a strand from inside one of its tasks will cause a deadlock");
+    synchronize();
+
+    // the drain task can still be between running the last task and lowering m_pending
+    while (m_pending.load() != 0)
+    {
+        std::this_thread::yield();
+    }
+}
+
+void strand::add(function_t function)
+{
+    m_queue.push(std::move(function));
+    if (m_pending.fetch_add(1) == 0)
+    {
+        m_pool.add([this] { drain(); });
+    }
+}
+
+void strand::synchronize()
+{
+    assert(!is_current_strand() && "Calling synchronize() inside the strand will cause a deadlock");
+    detail::event done;
+    add([&done]() { done.set(); });
+    done.wait();
+}
+
+bool strand::is_current_strand() const
+{
+    return t_strand == this;
+}
+
+void strand::drain()
+{
+    // strands can be drained on each other's stack, when a pool task calls into another pool
+    auto previous = t_strand;
+    t_strand = this;
+
+    function_t task;
+    for (std::size_t count = 0; count < batch_size; ++count)
+    {
+        // m_pending counts the task, but its producer can still be linking it into the queue
+        while (!m_queue.try_pop(task))
+        {
+            std::this_thread::yield();
+        }
+
+        try
+        {
+            task();
+        }
+        catch (...)
+        {
+            // exceptions are ignored, like on venus::executor
+        }
+        task = nullptr;
+
+        if (m_pending.fetch_sub(1) == 1)
+        {
+            // idle, the next add() schedules a new drain; this strand can be destroyed from here on
+            t_strand = previous;
+            return;
+        }
+    }
+
+    // give other strands a turn, this strand keeps its place because m_pending is not 0
+    t_strand = previous;
+    m_pool.add([this] { drain(); });
+}
+
+} // namespace venus
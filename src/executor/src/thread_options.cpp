@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#include "executor/thread_options.hpp"
+
+#include <cerrno>
+#include <exception>
+#include <future>
+#include <system_error>
+#include <utility>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace venus {
+
+namespace {
+
+[[noreturn]] void throw_system_error(int error, const char * what)
+{
+    throw std::system_error(error, std::generic_category(), what);
+}
+
+#if defined(__linux__)
+
+int native_policy(scheduling_policy policy)
+{
+    switch (policy)
+    {
+    case scheduling_policy::other:
+        return SCHED_OTHER;
+    case scheduling_policy::batch:
+        return SCHED_BATCH;
+    case scheduling_policy::idle:
+        return SCHED_IDLE;
+    case scheduling_policy::fifo:
+        return SCHED_FIFO;
+    case scheduling_policy::round_robin:
+        return SCHED_RR;
+    }
+    return SCHED_OTHER;
+}
+
+void set_name(const std::string & name)
+{
+    // the kernel keeps at most 15 characters and the terminating zero
+    auto truncated = name.substr(0, 15);
+    auto error = pthread_setname_np(pthread_self(), truncated.c_str());
+    if (error != 0)
+    {
+        throw_system_error(error, "pthread_setname_np");
+    }
+}
+
+void set_affinity(const std::vector<std::size_t> & cpus)
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (auto cpu : cpus)
+    {
+        if (cpu >= CPU_SETSIZE)
+        {
+            throw_system_error(EINVAL, "thread_options::m_cpus");
+        }
+        CPU_SET(cpu, &set);
+    }
+
+    auto error = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (error != 0)
+    {
+        throw_system_error(error, "pthread_setaffinity_np");
+    }
+}
+
+void set_scheduling(scheduling_policy policy, int priority)
+{
+    auto native = native_policy(policy);
+    sched_param parameters = {};
+    parameters.sched_priority = (native == SCHED_FIFO || native == SCHED_RR) ? priority : 0;
+    auto error = pthread_setschedparam(pthread_self(), native, &parameters);
+    if (error != 0)
+    {
+        throw_system_error(error, "pthread_setschedparam");
+    }
+}
+
+void set_nice(int nice)
+{
+    // on Linux the nice level is a property of the thread, setpriority() applies it to the thread id
+    auto tid = static_cast<id_t>(syscall(SYS_gettid));
+    if (setpriority(PRIO_PROCESS, tid, nice) != 0)
+    {
+        throw_system_error(errno, "setpriority");
+    }
+}
+
+#endif
+
+} // namespace
+
+void apply_thread_options(const thread_options & options)
+{
+#if defined(__linux__)
+    if (!options.m_name.empty())
+    {
+        set_name(options.m_name);
+    }
+    if (!options.m_cpus.empty())
+    {
+        set_affinity(options.m_cpus);
+    }
+    if (options.m_policy != scheduling_policy::other)
+    {
+        set_scheduling(options.m_policy, options.m_priority);
+    }
+    if (options.m_nice != 0)
+    {
+        set_nice(options.m_nice);
+    }
+#else
+    if (!options.m_name.empty() || !options.m_cpus.empty() || options.m_policy != scheduling_policy::other || options.m_nice != 0)
+    {
+        throw_system_error(static_cast<int>(std::errc::function_not_supported), "apply_thread_options");
+    }
+#endif
+}
+
+std::thread start_thread(const thread_options & options, std::function<void()> body)
+{
+    // the promise is owned by the thread, it may still be inside set_value() when this function returns
+    std::promise<void> applied;
+    auto started = applied.get_future();
+    std::thread thread([options, applied = std::move(applied), body = std::move(body)]() mutable {
+        try
+        {
+            apply_thread_options(options);
+            applied.set_value();
+        }
+        catch (...)
+        {
+            applied.set_exception(std::current_exception());
+            return;
+        }
+        body();
+    });
+
+    try
+    {
+        started.get();
+    }
+    catch (...)
+    {
+        thread.join();
+        throw;
+    }
+    return thread;
+}
+
+} // namespace venus
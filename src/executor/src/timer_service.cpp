@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#include "executor/timer_service.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace venus {
+
+timer_service::timer_service(timer_service_options options) :
+    m_parker(options.m_spin),
+    m_minimum_slack(options.m_minimum_slack),
+    m_thread(start_thread(options.m_thread, [this] { run(); }))
+{
+}
+
+timer_service::~timer_service()
+{
+    m_end = true;
+    m_parker.unpark();
+    m_thread.join();
+}
+
+call_t::id_t timer_service::insert(call_t && call, const void * owner)
+{
+    call.m_id = m_handles.acquire();
+    call.m_slack = std::max(call.m_slack, m_minimum_slack);
+    auto id = call.m_id;
+    m_registrations.push(registration{std::move(call), owner});
+    m_parker.unpark();
+    return id;
+}
+
+void timer_service::cancel(call_t::id_t id)
+{
+    if (!m_handles.cancel(id))
+    {
+        return;
+    }
+
+    // on the service thread, the call is reclaimed immediately, unless it is still in m_registrations;
+    // otherwise the service thread wakes up to reclaim the cancelled calls in bulk, long before their deadlines
+    if (is_service_thread())
+    {
+        if (m_calls.remove(id))
+        {
+            release(id);
+        }
+    }
+    else if (should_reclaim(m_size))
+    {
+        m_parker.unpark();
+    }
+}
+
+void timer_service::remove_owner(const void * owner)
+{
+    assert(!is_service_thread() && "remove_owner() on the service thread will cause a deadlock");
+    std::promise<void> done;
+    m_removals.push(removal{owner, &done});
+    m_parker.unpark();
+    done.get_future().get();
+}
+
+bool timer_service::is_service_thread() const
+{
+    return std::this_thread::get_id() == m_thread_id;
+}
+
+time_point_t timer_service::due() const
+{
+    return m_due;
+}
+
+std::size_t timer_service::missed_ticks() const
+{
+    return m_missed;
+}
+
+void timer_service::cancel_current()
+{
+    cancel(m_current);
+}
+
+std::size_t timer_service::size() const
+{
+    return m_size;
+}
+
+std::uint64_t timer_service::wakeups() const
+{
+    return m_wakeups;
+}
+
+void timer_service::run()
+{
+    m_thread_id = std::this_thread::get_id();
+    auto ready = [this] { return m_end || has_requests() || should_reclaim(m_size); };
+    while (!m_end)
+    {
+        take_requests();
+        reclaim_cancelled_calls();
+        m_size = m_calls.size();
+        if (m_calls.empty())
+        {
+            m_parker.park(ready);
+            continue;
+        }
+
+        auto deadline = m_calls.next_deadline();
+        auto now = clock_t::now();
+        if (now < deadline)
+        {
+            m_parker.park_until(ready, deadline);
+            continue;
+        }
+
+        // all calls that are due now are dispatched in this wakeup
+        ++m_wakeups;
+        while (!m_calls.empty() && m_calls.next_deadline() <= now)
+        {
+            dispatch();
+        }
+    }
+}
+
+bool timer_service::has_requests() const
+{
+    return !m_registrations.empty() || !m_removals.empty();
+}
+
+void timer_service::take_requests()
+{
+    registration added;
+    while (m_registrations.try_pop(added))
+    {
+        auto id = added.m_call.m_id;
+        if (!m_handles.active(id))
+        {
+            m_handles.release(id);
+            continue;
+        }
+        if (added.m_owner != nullptr)
+        {
+            m_owners[id] = added.m_owner;
+        }
+        m_calls.insert(std::move(added.m_call));
+    }
+
+    removal removed;
+    while (m_removals.try_pop(removed))
+    {
+        auto owner = removed.m_owner;
+        for (auto id : m_calls.remove_if([this, owner](const call_t & call) {
+                 auto it = m_owners.find(call.m_id);
+                 return it != m_owners.end() && it->second == owner;
+             }))
+        {
+            release(id);
+        }
+        m_size = m_calls.size();
+        removed.m_done->set_value();
+    }
+}
+
+void timer_service::dispatch()
+{
+    auto call = m_calls.pop_and_reschedule();
+    auto repeating = call.m_repeat_interval != duration_t::zero();
+    if (!m_handles.active(call.m_id))
+    {
+        // cancelled by another thread
+        if (repeating)
+        {
+            m_calls.remove(call.m_id);
+        }
+        release(call.m_id);
+        return;
+    }
+
+    m_current = call.m_id;
+    m_due = call.due();
+    m_missed = call.m_missed;
+    if (!repeating)
+    {
+        release(call.m_id);
+    }
+
+    try
+    {
+        call.m_function();
+    }
+    catch (...)
+    {
+        // the function only hands the call over to its owner, a failure there does not stop the other calls
+    }
+
+    if (repeating)
+    {
+        // if the function cancelled its call, the rescheduled call is gone and restore() destroys the function
+        auto now = call.m_missed_policy == missed_tick_policy::catch_up ? time_point_t::min() : clock_t::now();
+        m_calls.restore(std::move(call), now);
+    }
+}
+
+void timer_service::release(call_t::id_t id)
+{
+    m_handles.release(id);
+    m_owners.erase(id);
+}
+
+bool timer_service::should_reclaim(std::size_t size) const
+{
+    constexpr std::size_t minimum_cancelled = 1024;
+    auto cancelled = m_handles.cancelled_count();
+    return cancelled >= minimum_cancelled && cancelled * 2 >= size;
+}
+
+void timer_service::reclaim_cancelled_calls()
+{
+    if (!should_reclaim(m_calls.size()))
+    {
+        return;
+    }
+
+    for (auto id : m_calls.remove_if([this](const call_t & call) { return !m_handles.active(call.m_id); }))
+    {
+        release(id);
+    }
+}
+
+} // namespace venus
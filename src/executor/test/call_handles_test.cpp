@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#include "gmock/gmock.h"
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "executor/call_handles.hpp"
+
+TEST(call_handles, acquire_cancel_release)
+{
+    venus::call_handles handles;
+    auto id = handles.acquire();
+    ASSERT_NE(id, 0);
+    ASSERT_TRUE(handles.active(id));
+    ASSERT_EQ(handles.cancelled_count(), 0);
+
+    ASSERT_TRUE(handles.cancel(id));
+    ASSERT_FALSE(handles.cancel(id));
+    ASSERT_FALSE(handles.active(id));
+    ASSERT_EQ(handles.cancelled_count(), 1);
+
+    handles.release(id);
+    ASSERT_EQ(handles.cancelled_count(), 0);
+    ASSERT_FALSE(handles.active(id));
+}
+
+// a released slot is re-used with a new generation, the old id can no longer cancel it
+TEST(call_handles, generations)
+{
+    venus::call_handles handles;
+    auto first = handles.acquire();
+    handles.release(first);
+
+    auto second = handles.acquire();
+    ASSERT_NE(first, second);
+    ASSERT_EQ(static_cast<std::uint32_t>(first), static_cast<std::uint32_t>(second));
+    ASSERT_FALSE(handles.cancel(first));
+    ASSERT_TRUE(handles.active(second));
+}
+
+// a linked value stays with its id until release(), the next generation of the slot does not see it
+TEST(call_handles, link)
+{
+    venus::call_handles handles;
+    auto first = handles.acquire();
+    ASSERT_EQ(handles.linked(first), 0);
+    handles.link(first, 42);
+    ASSERT_TRUE(handles.cancel(first));
+    ASSERT_EQ(handles.linked(first), 42);
+    handles.release(first);
+    ASSERT_EQ(handles.linked(first), 0);
+
+    auto second = handles.acquire();
+    ASSERT_EQ(handles.linked(second), 0);
+    ASSERT_EQ(handles.linked(42), 0);
+}
+
+TEST(call_handles, unknown_ids)
+{
+    venus::call_handles handles;
+    ASSERT_FALSE(handles.active(0));
+    ASSERT_FALSE(handles.cancel(42));
+    ASSERT_FALSE(handles.cancel(~venus::call_handles::id_t(0)));
+}
+
+TEST(call_handles, concurrent_acquire)
+{
+    constexpr int threads_count = 4;
+    constexpr int count = 10000;
+
+    venus::call_handles handles;
+    std::vector<std::vector<venus::call_handles::id_t>> ids(threads_count);
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < threads_count; ++t)
+    {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < count; ++i)
+            {
+                ids[t].push_back(handles.acquire());
+            }
+        });
+    }
+
+    // release some ids while the other threads acquire
+    std::vector<venus::call_handles::id_t> released;
+    for (int i = 0; i < count; ++i)
+    {
+        auto id = handles.acquire();
+        handles.cancel(id);
+        handles.release(id);
+        released.push_back(id);
+    }
+
+    for (auto & thread : threads)
+    {
+        thread.join();
+    }
+
+    std::set<venus::call_handles::id_t> unique;
+    for (auto & thread_ids : ids)
+    {
+        for (auto id : thread_ids)
+        {
+            ASSERT_TRUE(handles.active(id));
+            unique.insert(id);
+        }
+    }
+    ASSERT_EQ(unique.size(), threads_count * count);
+    ASSERT_EQ(handles.cancelled_count(), 0);
+}
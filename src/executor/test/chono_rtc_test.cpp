@@ -7,6 +7,7 @@
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <future>
 #include <fmt/core.h>
 #include <mutex>
 #include <string>
@@ -18,6 +19,7 @@
 
 #include <fmt/core.h>
 
+#include "executor/executor.hpp"
 #include "support.hpp"
 
 using namespace std::chrono_literals;
@@ -210,3 +212,40 @@ TEST(chrono, rtc_behaviour_duration_steady_clock_timepoint)
         log_note("Normal", "Changing the RTC did nothing stop was set to true.\n");
     }
 }
+
+// the scheduled calls of the executor use the steady_clock, a jump of the realtime clock in either direction must not
+// make a call run early or late, also not in the precision timer mode, where the last part of the wait is a spin.
+void check_monotonic_immunity(const venus::executor_options & options)
+{
+    reset_rtc();
+
+    venus::executor executor(options);
+    auto start = std::chrono::steady_clock::now();
+    std::promise<std::chrono::steady_clock::duration> fired;
+    executor.call_after(1s, [&] { fired.set_value(std::chrono::steady_clock::now() - start); });
+    auto elapsed = fired.get_future();
+
+    forward_rtc();
+    std::this_thread::sleep_for(200ms);
+    reset_rtc(); // one hour back
+    ASSERT_EQ(elapsed.wait_for(10s), std::future_status::ready);
+
+    auto delay = elapsed.get();
+    ASSERT_GE(delay, 1s);
+    ASSERT_LT(delay, 2s);
+    ASSERT_EQ(executor.stats().m_lateness.count(), 1);
+    log_note("Normal", fmt::format("the call ran {}us after its deadline, the RTC changes had no effect.\n",
+                           std::chrono::duration_cast<std::chrono::microseconds>(delay - 1s).count()));
+}
+
+TEST(chrono, rtc_behaviour_executor_call_after)
+{
+    check_monotonic_immunity(venus::executor_options());
+}
+
+TEST(chrono, rtc_behaviour_executor_precision_timer)
+{
+    venus::executor_options options;
+    options.m_precision_window = 100us;
+    check_monotonic_immunity(options);
+}
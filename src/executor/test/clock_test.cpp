@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#include "gmock/gmock.h"
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <future>
+#include <stdexcept>
+#include <vector>
+
+#include "executor/clock.hpp"
+#include "executor/executor.hpp"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+venus::executor_options with_clock(venus::clock_source & clock)
+{
+    venus::executor_options options;
+    options.m_clock = &clock;
+    return options;
+}
+
+} // namespace
+
+TEST(clock, manual_clock_only_moves_when_advanced)
+{
+    venus::manual_clock clock;
+    venus::executor executor(with_clock(clock));
+    ASSERT_EQ(executor.now(), venus::time_point_t());
+
+    std::vector<int> fired;
+    executor.call_after(5min, [&] { fired.push_back(5); });
+    executor.call_after(1min, [&] { fired.push_back(1); });
+
+    clock.advance(59s);
+    ASSERT_TRUE(executor.call([&] { return fired.empty(); }));
+
+    clock.advance(1s);
+    ASSERT_THAT(executor.call([&] { return fired; }), testing::ElementsAre(1));
+
+    clock.advance(1h);
+    ASSERT_THAT(executor.call([&] { return fired; }), testing::ElementsAre(1, 5));
+    ASSERT_EQ(clock.now(), venus::time_point_t() + 1h + 1min);
+
+    // the time never moves back
+    clock.advance_to(venus::time_point_t());
+    ASSERT_EQ(clock.now(), venus::time_point_t() + 1h + 1min);
+}
+
+// an hour of one second heartbeats runs without sleeping, every tick is on time in the simulated time
+TEST(clock, simulate_an_hour)
+{
+    venus::manual_clock clock;
+    venus::executor executor(with_clock(clock));
+    std::size_t ticks = 0;
+    auto call = executor.call_every(executor.now() + 1s, 1s, [&] {
+        EXPECT_EQ(executor.lateness(), venus::duration_t::zero());
+        ++ticks;
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 3600; ++i)
+    {
+        clock.advance(1s);
+    }
+    ASSERT_LT(std::chrono::steady_clock::now() - start, 1h);
+    call.cancel();
+    executor.synchronize();
+    ASSERT_EQ(ticks, 3600);
+}
+
+// a jump of the clock is a late executor, the missed tick policy decides what happens to the ticks in between
+TEST(clock, missed_ticks_after_a_jump)
+{
+    venus::manual_clock clock;
+    venus::executor executor(with_clock(clock));
+    std::vector<std::size_t> catch_up;
+    std::vector<std::size_t> coalesce;
+    executor.call_every(1s, venus::missed_tick_policy::catch_up, [&](std::size_t missed) { catch_up.push_back(missed); });
+    executor.call_every(1s, venus::missed_tick_policy::coalesce, [&](std::size_t missed) { coalesce.push_back(missed); });
+
+    clock.advance(10s);
+    executor.synchronize();
+    ASSERT_EQ(catch_up.size(), 11);
+    ASSERT_THAT(coalesce, testing::ElementsAre(0, 9));
+}
+
+// a scheduled call that advances the clock itself, its own executor runs the due calls after it returns
+TEST(clock, advance_from_a_scheduled_call)
+{
+    venus::manual_clock clock;
+    venus::executor executor(with_clock(clock));
+    std::promise<void> done;
+    executor.call_after(1s, [&] {
+        executor.call_after(1s, [&] { done.set_value(); });
+        clock.advance(1s);
+    });
+    clock.advance(1s);
+    done.get_future().wait();
+}
+
+// a task that advances the clock while another executor is blocked on it, the blocked executor runs its due calls later
+TEST(clock, advance_while_another_executor_waits)
+{
+    venus::manual_clock clock;
+    venus::executor first(with_clock(clock));
+    venus::executor second(with_clock(clock));
+    std::promise<void> done;
+    second.call_after(1s, [&] { done.set_value(); });
+    second.call([&] { first.call([&] { clock.advance(1s); }); });
+    done.get_future().wait();
+}
+
+// a clock that moves past the deadline between the check of the executor and its wait, steady_time() is min()
+TEST(clock, deadline_passes_before_the_wait)
+{
+    struct jumping_clock : venus::clock_source
+    {
+        venus::time_point_t now() const override
+        {
+            return venus::time_point_t(venus::duration_t(m_now.load()));
+        }
+
+        venus::time_point_t steady_time(venus::time_point_t deadline) const override
+        {
+            m_now = deadline.time_since_epoch().count();
+            return venus::time_point_t::min();
+        }
+
+        void subscribe(const void *, listener_t) override
+        {
+        }
+
+        void unsubscribe(const void *) override
+        {
+        }
+
+        mutable std::atomic<venus::duration_t::rep> m_now = {0};
+    } clock;
+
+    auto options = with_clock(clock);
+    options.m_precision_window = 100us;
+    venus::executor executor(options);
+    std::promise<void> done;
+    executor.call_after(1h, [&] { done.set_value(); });
+    ASSERT_EQ(done.get_future().wait_for(10s), std::future_status::ready);
+}
+
+TEST(clock, scaled_clock)
+{
+    venus::scaled_clock clock(100.0);
+    venus::executor executor(with_clock(clock));
+    std::promise<void> done;
+    auto start = std::chrono::steady_clock::now();
+    executor.call_after(2s, [&] { done.set_value(); });
+    done.get_future().wait();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    ASSERT_GE(elapsed, 19ms);
+    ASSERT_LT(elapsed, 1s);
+    ASSERT_THROW(venus::scaled_clock(0.0), std::invalid_argument);
+}
+
+// a deadline too far away to represent is waited for in steps, a deadline in the past is due right away
+TEST(clock, scaled_clock_extreme_deadlines)
+{
+    venus::scaled_clock clock(0.5);
+    auto now = venus::clock_t::now();
+    auto latest = clock.steady_time(venus::time_point_t::max());
+    ASSERT_GT(latest, now + 1h);
+    ASSERT_LT(latest, venus::time_point_t::max());
+    ASSERT_LE(clock.steady_time(venus::time_point_t::min()), now);
+
+    venus::executor executor(with_clock(clock));
+    std::promise<void> done;
+    executor.call_at(venus::time_point_t::max(), [] {});
+    executor.call_after(1ms, [&] { done.set_value(); });
+    done.get_future().wait();
+}
+
+TEST(clock, not_with_a_timer_service)
+{
+    venus::manual_clock clock;
+    venus::timer_service service;
+    auto options = with_clock(clock);
+    options.m_timer_service = &service;
+    ASSERT_THROW(venus::executor executor(options), std::invalid_argument);
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "executor/coroutine.hpp"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+venus::task<int> answer()
+{
+    co_return 42;
+}
+
+venus::task<std::string> on_executor(venus::executor & executor)
+{
+    co_await executor.schedule();
+    co_return executor.is_executor_thread() ? "executor" : "elsewhere";
+}
+
+venus::task<int> add_on_pool(venus::pool_executor & pool, int lhs, int rhs)
+{
+    co_await pool.schedule();
+    EXPECT_TRUE(pool.is_pool_thread());
+    co_return lhs + rhs;
+}
+
+venus::task<> fail()
+{
+    throw std::runtime_error("failed");
+    co_return;
+}
+
+} // namespace
+
+TEST(coroutine, spawn_task)
+{
+    venus::executor executor;
+    ASSERT_EQ(venus::spawn(executor, answer()).get(), 42);
+    ASSERT_EQ(venus::spawn(executor, on_executor(executor)).get(), "executor");
+}
+
+TEST(coroutine, schedule_hops_between_executors)
+{
+    venus::executor executor;
+    venus::pool_executor pool(2);
+
+    auto flow = [&]() -> venus::task<std::vector<bool>> {
+        std::vector<bool> on_executor_thread;
+        on_executor_thread.push_back(executor.is_executor_thread());
+        co_await pool.schedule();
+        on_executor_thread.push_back(executor.is_executor_thread());
+        co_await executor.schedule();
+        on_executor_thread.push_back(executor.is_executor_thread());
+        co_return on_executor_thread;
+    };
+    ASSERT_EQ(venus::spawn(executor, flow()).get(), (std::vector<bool>{true, false, true}));
+}
+
+TEST(coroutine, after)
+{
+    venus::executor executor;
+    auto flow = [&]() -> venus::task<std::chrono::steady_clock::duration> {
+        auto start = std::chrono::steady_clock::now();
+        co_await executor.after(20ms);
+        EXPECT_TRUE(executor.is_executor_thread());
+        co_return std::chrono::steady_clock::now() - start;
+    };
+    ASSERT_GE(venus::spawn(executor, flow()).get(), 20ms);
+}
+
+// the awaiting coroutine continues on its own executor, also when the awaited task finished on a pool thread
+TEST(coroutine, task_resumes_on_awaiting_executor)
+{
+    venus::executor executor;
+    venus::pool_executor pool(2);
+
+    auto flow = [&]() -> venus::task<int> {
+        int sum = 0;
+        for (int i = 0; i < 100; ++i)
+        {
+            sum += co_await add_on_pool(pool, i, 1);
+            EXPECT_TRUE(executor.is_executor_thread());
+        }
+        co_return sum + co_await answer();
+    };
+    ASSERT_EQ(venus::spawn(executor, flow()).get(), 5050 + 42);
+}
+
+TEST(coroutine, strand)
+{
+    venus::pool_executor pool(4);
+    venus::strand strand(pool);
+    int counter = 0;
+
+    auto increment = [&]() -> venus::task<> {
+        for (int i = 0; i < 100; ++i)
+        {
+            co_await pool.schedule();
+            co_await strand.schedule();
+            ++counter; // serialized by the strand
+        }
+    };
+
+    std::vector<venus::future<void>> flows;
+    for (int i = 0; i < 8; ++i)
+    {
+        flows.push_back(venus::spawn(strand, increment()));
+    }
+    for (auto & flow : flows)
+    {
+        flow.get();
+    }
+    ASSERT_EQ(strand.call([&] { return counter; }), 800);
+}
+
+TEST(coroutine, exceptions_propagate)
+{
+    venus::executor executor;
+    auto flow = [&]() -> venus::task<std::string> {
+        try
+        {
+            co_await fail();
+        }
+        catch (const std::runtime_error & e)
+        {
+            co_return e.what();
+        }
+        co_return "not thrown";
+    };
+    ASSERT_EQ(venus::spawn(executor, flow()).get(), "failed");
+    ASSERT_THROW(venus::spawn(executor, fail()).get(), std::runtime_error);
+}
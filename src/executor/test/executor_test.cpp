@@ -3,6 +3,7 @@
  */
 
 #include "gmock/gmock.h"
+#include <atomic>
 #include <future>
 #include <gtest/gtest.h>
 
@@ -10,6 +11,7 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "executor/executor.hpp"
@@ -84,6 +86,318 @@ TEST(executor, ordering_sequence)
     ASSERT_THAT(sequence, testing::ElementsAre(1, 2, 3, 4, 5));
 }
 
+// tasks of every single producer thread are executed in the order that thread added them
+TEST(executor, multiple_producers)
+{
+    constexpr int producers = 4;
+    constexpr int count = 1000;
+
+    std::vector<int> next(producers, 0);
+    bool in_order = true;
+    {
+        venus::executor executor;
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; ++p)
+        {
+            threads.emplace_back([&, p] {
+                for (int i = 0; i < count; ++i)
+                {
+                    executor.add([&, p, i] { in_order = in_order && next[static_cast<std::size_t>(p)]++ == i; });
+                }
+            });
+        }
+
+        for (auto & thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    ASSERT_TRUE(in_order);
+    ASSERT_THAT(next, testing::Each(count));
+}
+
+TEST(executor, add_bulk)
+{
+    std::vector<int> sequence;
+    {
+        venus::executor executor;
+        executor.add([&] { sequence.push_back(0); });
+
+        std::vector<venus::function_t> tasks;
+        for (int i = 1; i < 100; ++i)
+        {
+            tasks.emplace_back([&, i] { sequence.push_back(i); });
+        }
+        executor.add_bulk(std::move(tasks));
+        executor.add_bulk({});
+        executor.call([&] { sequence.push_back(100); });
+    }
+
+    ASSERT_EQ(sequence.size(), 101);
+    for (std::size_t i = 0; i < sequence.size(); ++i)
+    {
+        ASSERT_EQ(sequence[i], static_cast<int>(i));
+    }
+}
+
+TEST(executor, move_only_tasks)
+{
+    venus::executor executor;
+    auto value = std::make_unique<int>(42);
+    auto future = executor.call_async([value = std::move(value)] { return *value; });
+    ASSERT_EQ(future.get(), 42);
+}
+
+// a repeating call keeps its (move-only) function between runs, also when it cancels itself
+TEST(executor, call_every)
+{
+    venus::executor executor;
+    std::promise<void> done;
+    auto count = std::make_unique<int>(0);
+    std::unique_ptr<venus::scheduled_call> repeating;
+
+    // registered from the executor thread, so `repeating` is assigned before the first run
+    executor.call([&] {
+        repeating = std::make_unique<venus::scheduled_call>(executor.call_every(100us, [&, count = std::move(count)] {
+            if (++*count == 3)
+            {
+                repeating->cancel();
+                done.set_value();
+            }
+        }));
+    });
+
+    done.get_future().wait();
+    executor.synchronize();
+}
+
+// cancel() from another thread does not wait for the executor thread
+TEST(executor, cancel_does_not_block)
+{
+    venus::executor executor;
+    std::atomic<bool> fired(false);
+    std::promise<void> release;
+    auto released = release.get_future().share();
+
+    auto scheduled_call = executor.call_after(1ms, [&] { fired = true; });
+    executor.add([released] { released.wait(); });
+
+    // the executor thread is blocked, cancel() still returns
+    scheduled_call.cancel();
+    release.set_value();
+
+    executor.call_after(2ms, [] {});
+    std::this_thread::sleep_for(5ms);
+    executor.synchronize();
+    ASSERT_FALSE(fired);
+}
+
+// calls cancelled by another thread are reclaimed before their deadline, once they make up most of m_scheduled_calls
+TEST(executor, reclaim_cancelled_calls)
+{
+    venus::executor executor;
+    auto value = std::make_shared<int>(0);
+
+    std::vector<venus::scheduled_call> calls;
+    for (int i = 0; i < 2000; ++i)
+    {
+        calls.push_back(executor.call_after(1h, [value] {}));
+    }
+    executor.synchronize();
+    ASSERT_EQ(value.use_count(), 2001);
+
+    for (auto & call : calls)
+    {
+        call.cancel();
+    }
+
+    for (int i = 0; i < 1000 && executor.call([&] { return value.use_count(); }) != 1; ++i)
+    {
+        std::this_thread::sleep_for(1ms);
+    }
+    ASSERT_EQ(value.use_count(), 1);
+}
+
+TEST(executor, stats)
+{
+    venus::executor executor; // the constructor synchronizes with the executor thread, with one task per lane
+
+    // the executor thread is blocked in a scheduled call, it sees the queued tasks when it starts to drain the queue
+    std::promise<void> started;
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    executor.call_after(0ms, [&started, released] {
+        started.set_value();
+        released.wait();
+    });
+    started.get_future().wait();
+    for (int i = 0; i < 10; ++i)
+    {
+        executor.add([] {}, venus::priority::background);
+    }
+
+    auto stats = executor.stats();
+    ASSERT_EQ(stats.m_submitted, 13);
+    ASSERT_EQ(stats.m_queue_depth, 10);
+    ASSERT_EQ(stats.m_lane_depth[venus::lane_index(venus::priority::background)], 10);
+
+    release.set_value();
+    executor.synchronize();
+    ASSERT_GE(executor.stats().m_peak_queue_depth, 10);
+
+    auto scheduled_call = executor.call_after(1h, [] {});
+    executor.call_after(1ms, [] {});
+    for (int i = 0; i < 1000 && executor.stats().m_scheduled_calls_executed < 2; ++i)
+    {
+        std::this_thread::sleep_for(1ms);
+    }
+    executor.synchronize();
+
+    stats = executor.stats();
+    ASSERT_EQ(stats.m_submitted, 19);
+    ASSERT_EQ(stats.m_executed, 19);
+    ASSERT_EQ(stats.m_queue_depth, 0);
+    ASSERT_THAT(stats.m_lane_depth, testing::Each(0));
+    ASSERT_EQ(stats.m_queue_wait.count(), 19);
+    ASSERT_GE(stats.m_task_duration.count(), 18);
+    ASSERT_EQ(stats.m_scheduled_calls, 1);
+    ASSERT_EQ(stats.m_scheduled_calls_executed, 2);
+    ASSERT_EQ(stats.m_lateness.count(), 2);
+    scheduled_call.cancel();
+}
+
+// higher lanes go first, each lane is FIFO
+TEST(executor, priority_lanes)
+{
+    venus::executor executor;
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    executor.add([released] { released.wait(); });
+
+    std::vector<std::string> order;
+    executor.add([&] { order.push_back("background 1"); }, venus::priority::background);
+    executor.add([&] { order.push_back("normal 1"); });
+    executor.add([&] { order.push_back("high 1"); }, venus::priority::high);
+    executor.add([&] { order.push_back("background 2"); }, venus::priority::background);
+    executor.add([&] { order.push_back("high 2"); }, venus::priority::high);
+    executor.add([&] { order.push_back("normal 2"); });
+    release.set_value();
+    executor.synchronize();
+
+    ASSERT_THAT(order, testing::ElementsAre("high 1", "high 2", "normal 1", "normal 2", "background 1", "background 2"));
+}
+
+// a background task runs after at most aging_limit higher priority tasks
+TEST(executor, priority_aging)
+{
+    venus::executor executor;
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    executor.add([released] { released.wait(); });
+
+    std::size_t high_tasks_before = 0;
+    std::size_t high_tasks = 0;
+    executor.add([&] { high_tasks_before = high_tasks; }, venus::priority::background);
+    for (std::size_t i = 0; i < 10 * venus::executor::aging_limit; ++i)
+    {
+        executor.add([&] { ++high_tasks; }, venus::priority::high);
+    }
+    release.set_value();
+    executor.synchronize();
+
+    ASSERT_EQ(high_tasks, 10 * venus::executor::aging_limit);
+    ASSERT_EQ(high_tasks_before, venus::executor::aging_limit);
+}
+
+// a periodic call that overruns is not run back-to-back for the ticks it missed
+TEST(executor, call_every_coalesce)
+{
+    venus::executor executor;
+    std::vector<std::size_t> missed;
+    std::promise<void> done;
+    auto scheduled_call = executor.call_every(5ms, venus::missed_tick_policy::coalesce, [&](std::size_t missed_ticks) {
+        missed.push_back(missed_ticks);
+        if (missed.size() == 1)
+        {
+            std::this_thread::sleep_for(28ms);
+        }
+        else if (missed.size() == 2)
+        {
+            done.set_value();
+        }
+    });
+    done.get_future().wait();
+    scheduled_call.cancel();
+    executor.synchronize();
+
+    ASSERT_GE(missed.size(), 2);
+    ASSERT_EQ(missed[0], 0);
+    ASSERT_GE(missed[1], 4);
+}
+
+// the busy-poll mode never sleeps, tasks and timers work the same
+TEST(executor, busy_poll)
+{
+    venus::executor_options options;
+    options.m_busy_poll = true;
+    venus::executor executor(options);
+
+    ASSERT_EQ(executor.call([] { return 42; }), 42);
+    std::promise<void> fired;
+    executor.call_after(1ms, [&] { fired.set_value(); });
+    ASSERT_EQ(fired.get_future().wait_for(10s), std::future_status::ready);
+}
+
+// the precision timer mode never runs a call before its deadline, lateness() reports how late each call started
+TEST(executor, precision_timer)
+{
+    venus::executor_options options;
+    options.m_precision_window = 200us;
+    venus::executor executor(options);
+
+    constexpr int calls = 20;
+    std::vector<venus::duration_t> lateness;
+    std::promise<void> done;
+    for (int i = 1; i <= calls; ++i)
+    {
+        auto deadline = std::chrono::steady_clock::now() + i * 1ms;
+        executor.call_at(deadline, [&, deadline] {
+            EXPECT_GE(std::chrono::steady_clock::now(), deadline);
+            lateness.push_back(executor.lateness());
+            if (lateness.size() == calls)
+            {
+                done.set_value();
+            }
+        });
+    }
+    done.get_future().wait();
+
+    for (auto late : lateness)
+    {
+        ASSERT_GE(late, venus::duration_t::zero());
+    }
+    ASSERT_EQ(executor.stats().m_lateness.count(), calls);
+}
+
+TEST(executor, duration_histogram)
+{
+    using venus::duration_histogram;
+    ASSERT_EQ(duration_histogram::bucket(-5ns), 0);
+    ASSERT_EQ(duration_histogram::bucket(0ns), 0);
+    ASSERT_EQ(duration_histogram::bucket(1ns), 1);
+    ASSERT_EQ(duration_histogram::bucket(1023ns), 10);
+    ASSERT_EQ(duration_histogram::bucket(1024ns), 11);
+    ASSERT_EQ(duration_histogram::upper_bound(11), 2048ns);
+
+    duration_histogram histogram;
+    ASSERT_EQ(histogram.percentile(0.5), 0ns);
+    histogram.m_buckets[duration_histogram::bucket(100ns)] = 98;
+    histogram.m_buckets[duration_histogram::bucket(1ms)] = 2;
+    ASSERT_EQ(histogram.count(), 100);
+    ASSERT_EQ(histogram.percentile(0.5), 128ns);
+    ASSERT_EQ(histogram.percentile(0.99), duration_histogram::upper_bound(duration_histogram::bucket(1ms)));
+}
 
 int main(int argc, char ** argv)
 {
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#include "gmock/gmock.h"
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "executor/executor.hpp"
+#include "executor/future.hpp"
+#include "executor/pool_executor.hpp"
+
+TEST(future, promise_get)
+{
+    venus::promise<int> promise;
+    auto future = promise.get_future();
+    ASSERT_TRUE(future.valid());
+    ASSERT_FALSE(future.ready());
+    ASSERT_THROW(promise.get_future(), std::future_error);
+
+    std::thread producer([&] { promise.set_value(42); });
+    ASSERT_EQ(future.get(), 42);
+    ASSERT_FALSE(future.valid());
+    producer.join();
+    ASSERT_THROW(promise.set_value(1), std::future_error);
+}
+
+TEST(future, broken_promise)
+{
+    venus::future<void> future;
+    {
+        venus::promise<void> promise;
+        future = promise.get_future();
+    }
+    ASSERT_TRUE(future.ready());
+    ASSERT_THROW(future.get(), std::future_error);
+}
+
+// a continuation added to a ready future runs right away, otherwise on the thread that completes the promise
+TEST(future, then_inline)
+{
+    venus::promise<int> promise;
+    auto first = promise.get_future().then([](int value) { return std::to_string(value); });
+    ASSERT_FALSE(first.ready());
+    promise.set_value(7);
+    ASSERT_TRUE(first.ready());
+
+    std::string result;
+    auto second = first.then([&](std::string value) { result = value + "!"; });
+    ASSERT_TRUE(second.ready());
+    ASSERT_EQ(result, "7!");
+}
+
+TEST(future, move_only_value)
+{
+    venus::promise<std::unique_ptr<int>> promise;
+    auto future = promise.get_future().then([](std::unique_ptr<int> value) { return std::make_unique<int>(*value * 2); });
+    promise.set_value(std::make_unique<int>(21));
+    ASSERT_EQ(*future.get(), 42);
+}
+
+// an exception skips the continuations after the stage that threw and is rethrown by get()
+TEST(future, exception_propagates)
+{
+    int called = 0;
+    venus::promise<int> promise;
+    auto future = promise.get_future()
+                      .then([&](int value) { ++called; if (value > 0) throw std::runtime_error("too large"); return value; })
+                      .then([&](int value) { ++called; return value; });
+    promise.set_value(1);
+    ASSERT_THROW(future.get(), std::runtime_error);
+    ASSERT_EQ(called, 1);
+}
+
+// executor -> pool work -> back to executor, without blocking a thread in between
+TEST(future, then_on_executors)
+{
+    venus::executor executor;
+    venus::pool_executor pool(2);
+
+    auto future = venus::async(executor, [&] { EXPECT_TRUE(executor.is_executor_thread()); return 20; })
+                      .then(pool, [&](int value) { EXPECT_TRUE(pool.is_pool_thread()); return value + 1; })
+                      .then(executor, [&](int value) { EXPECT_TRUE(executor.is_executor_thread()); return value * 2; });
+    ASSERT_EQ(future.get(), 42);
+}
+
+TEST(future, via)
+{
+    venus::executor executor;
+    venus::promise<void> promise;
+    bool on_executor = false;
+    auto future = promise.get_future().via(executor).then([&] { on_executor = executor.is_executor_thread(); });
+    promise.set_value();
+    future.get();
+    ASSERT_TRUE(on_executor);
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#include "gmock/gmock.h"
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "executor/guarded.hpp"
+
+namespace {
+
+// the invariant m_negative == -m_positive holds for every consistent copy
+struct pair
+{
+    std::int64_t m_positive;
+    std::int64_t m_negative;
+    std::int64_t m_padding[4];
+};
+
+} // namespace
+
+TEST(guarded, shared_and_unique_lock)
+{
+    venus::guarded<std::vector<int>> numbers({1, 2, 3});
+    ASSERT_EQ(numbers.with_shared_lock([](const std::vector<int> & v) { return v.size(); }), 3);
+    numbers.with_unique_lock([](std::vector<int> & v) { v.push_back(4); });
+    numbers.with_lock([](std::vector<int> & v) { v.push_back(5); });
+
+    std::vector<std::thread> readers;
+    std::atomic<std::size_t> total = {0};
+    for (int i = 0; i < 4; ++i)
+    {
+        readers.emplace_back([&] { total += numbers.with_shared_lock([](const std::vector<int> & v) { return v.size(); }); });
+    }
+    for (auto & reader : readers)
+    {
+        reader.join();
+    }
+    ASSERT_EQ(total, 20);
+}
+
+// a snapshot does not change when a writer publishes a new one
+TEST(guarded, snapshot_is_immutable)
+{
+    venus::guarded_snapshot<std::map<std::string, int>> routes({{"a", 1}});
+    auto before = routes.snapshot();
+    routes.update([](std::map<std::string, int> & table) { table["b"] = 2; });
+    auto after = routes.snapshot();
+
+    ASSERT_EQ(before->size(), 1);
+    ASSERT_EQ(after->size(), 2);
+    routes.store({});
+    ASSERT_TRUE(routes.snapshot()->empty());
+    ASSERT_EQ(after->size(), 2);
+}
+
+TEST(guarded, snapshot_concurrent_updates)
+{
+    venus::guarded_snapshot<int> counter(0);
+    std::vector<std::thread> threads;
+    std::atomic<bool> stop = {false};
+    std::thread reader([&] {
+        int last = 0;
+        while (!stop)
+        {
+            auto current = *counter.snapshot();
+            EXPECT_GE(current, last);
+            last = current;
+        }
+    });
+    for (int i = 0; i < 4; ++i)
+    {
+        threads.emplace_back([&] {
+            for (int j = 0; j < 1000; ++j)
+            {
+                counter.update([](int & value) { ++value; });
+            }
+        });
+    }
+    for (auto & thread : threads)
+    {
+        thread.join();
+    }
+    stop = true;
+    reader.join();
+    ASSERT_EQ(*counter.snapshot(), 4000);
+}
+
+// readers never see a half written value
+TEST(guarded, seqlock_consistent_copies)
+{
+    venus::guarded_seqlock<pair> shared(pair{0, 0, {}});
+    std::atomic<bool> stop = {false};
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 3; ++i)
+    {
+        readers.emplace_back([&] {
+            while (!stop)
+            {
+                auto copy = shared.load();
+                ASSERT_EQ(copy.m_negative, -copy.m_positive);
+            }
+        });
+    }
+
+    for (std::int64_t i = 1; i <= 20000; ++i)
+    {
+        if (i % 2 == 0)
+        {
+            shared.store(pair{i, -i, {}});
+        }
+        else
+        {
+            shared.update([](pair & value) {
+                ++value.m_positive;
+                --value.m_negative;
+            });
+        }
+    }
+    stop = true;
+    for (auto & reader : readers)
+    {
+        reader.join();
+    }
+    ASSERT_EQ(shared.load().m_positive, 20000);
+}
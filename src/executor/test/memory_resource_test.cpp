@@ -0,0 +1,272 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#include "gmock/gmock.h"
+#include <gtest/gtest.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <map>
+#include <memory>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "executor/executor.hpp"
+#include "executor/memory_resource.hpp"
+#include "executor/mpsc_queue.hpp"
+#include "executor/unique_task.hpp"
+
+using namespace std::chrono_literals;
+
+TEST(memory_resource, new_delete_alignment)
+{
+    auto resource = venus::new_delete_resource();
+    for (std::size_t alignment : {8u, 16u, 64u, 4096u})
+    {
+        auto p = resource->allocate(100, alignment);
+        ASSERT_EQ(reinterpret_cast<std::uintptr_t>(p) % alignment, 0);
+        resource->deallocate(p, 100, alignment);
+    }
+    ASSERT_TRUE(*resource == *venus::new_delete_resource());
+}
+
+// deallocated blocks are re-used, the upstream resource is only called for new slabs
+TEST(memory_resource, slab_recycles_blocks)
+{
+    venus::slab_resource slab;
+    std::vector<void *> blocks;
+    for (int round = 0; round < 3; ++round)
+    {
+        for (int i = 0; i < 1000; ++i)
+        {
+            blocks.push_back(slab.allocate(100));
+        }
+        for (auto block : blocks)
+        {
+            slab.deallocate(block, 100);
+        }
+        blocks.clear();
+    }
+
+    auto stats = slab.stats();
+    ASSERT_EQ(stats.m_allocations, 3000);
+    ASSERT_EQ(stats.m_deallocations, 3000);
+    ASSERT_EQ(stats.m_bytes_in_use, 0);
+    // 1000 blocks of 128 bytes fit in three slabs, the free list links take 4 bytes per block
+    ASSERT_EQ(venus::slab_resource::blocks_per_slab(128), 496);
+    ASSERT_EQ(stats.m_upstream_allocations, 3);
+    ASSERT_EQ(stats.m_upstream_bytes, 3 * venus::slab_resource::slab_size);
+}
+
+// a failed upstream allocation leaves the counters as they were
+TEST(memory_resource, slab_upstream_failure)
+{
+    struct failing_resource : venus::memory_resource
+    {
+        void * do_allocate(std::size_t, std::size_t) override
+        {
+            throw std::bad_alloc();
+        }
+
+        void do_deallocate(void *, std::size_t, std::size_t) override
+        {
+        }
+
+        bool do_is_equal(const venus::memory_resource & other) const noexcept override
+        {
+            return this == &other;
+        }
+    } upstream;
+
+    venus::slab_resource slab(&upstream);
+    ASSERT_THROW(slab.allocate(100), std::bad_alloc);
+    ASSERT_THROW(slab.allocate(venus::slab_resource::max_block_size + 1), std::bad_alloc);
+    auto stats = slab.stats();
+    ASSERT_EQ(stats.m_allocations, 0);
+    ASSERT_EQ(stats.m_bytes_in_use, 0);
+    ASSERT_EQ(stats.m_upstream_allocations, 0);
+    ASSERT_EQ(stats.m_upstream_bytes, 0);
+}
+
+// producers allocate and a consumer deallocates, like the queue nodes of an executor, no block is handed out twice
+TEST(memory_resource, slab_producers_and_consumer)
+{
+    constexpr std::size_t producer_count = 4;
+    constexpr std::size_t per_producer = 20000;
+
+    venus::slab_resource slab;
+    venus::mpsc_queue<std::uint64_t *> blocks;
+    std::vector<std::thread> producers;
+    for (std::size_t p = 0; p < producer_count; ++p)
+    {
+        producers.emplace_back([&, p] {
+            for (std::size_t i = 0; i < per_producer; ++i)
+            {
+                auto block = static_cast<std::uint64_t *>(slab.allocate(64));
+                *block = p * per_producer + i;
+                blocks.push(block);
+            }
+        });
+    }
+
+    std::vector<bool> seen(producer_count * per_producer);
+    for (std::size_t received = 0; received < seen.size();)
+    {
+        std::uint64_t * block = nullptr;
+        if (!blocks.try_pop(block))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        EXPECT_FALSE(seen[*block]);
+        seen[*block] = true;
+        slab.deallocate(block, 64);
+        ++received;
+    }
+    for (auto & producer : producers)
+    {
+        producer.join();
+    }
+
+    auto stats = slab.stats();
+    ASSERT_EQ(stats.m_allocations, producer_count * per_producer);
+    ASSERT_EQ(stats.m_deallocations, producer_count * per_producer);
+    ASSERT_EQ(stats.m_bytes_in_use, 0);
+}
+
+// the free blocks and the counters of a thread are returned to the resource when the thread ends
+TEST(memory_resource, slab_thread_exit_returns_blocks)
+{
+    venus::slab_resource slab;
+    std::thread([&] {
+        std::vector<void *> blocks;
+        for (int i = 0; i < 1000; ++i)
+        {
+            blocks.push_back(slab.allocate(64));
+        }
+        for (auto block : blocks)
+        {
+            slab.deallocate(block, 64);
+        }
+    }).join();
+
+    auto stats = slab.stats();
+    ASSERT_EQ(stats.m_allocations, 1000);
+    ASSERT_EQ(stats.m_deallocations, 1000);
+    ASSERT_EQ(stats.m_bytes_in_use, 0);
+
+    std::vector<void *> blocks;
+    for (int i = 0; i < 1000; ++i)
+    {
+        blocks.push_back(slab.allocate(64));
+    }
+    ASSERT_EQ(slab.stats().m_upstream_allocations, stats.m_upstream_allocations);
+    for (auto block : blocks)
+    {
+        slab.deallocate(block, 64);
+    }
+}
+
+TEST(memory_resource, slab_large_and_aligned_blocks)
+{
+    venus::slab_resource slab;
+    auto large = slab.allocate(venus::slab_resource::max_block_size + 1);
+    auto aligned = slab.allocate(32, 64);
+    auto small = slab.allocate(1);
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(aligned) % 64, 0);
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(small) % alignof(std::max_align_t), 0);
+    ASSERT_EQ(slab.stats().m_bytes_in_use, venus::slab_resource::max_block_size + 1 + 32 + 1);
+
+    slab.deallocate(large, venus::slab_resource::max_block_size + 1);
+    slab.deallocate(aligned, 32, 64);
+    slab.deallocate(small, 1);
+    auto stats = slab.stats();
+    ASSERT_EQ(stats.m_bytes_in_use, 0);
+    ASSERT_EQ(stats.m_upstream_allocations, 3);
+    ASSERT_EQ(stats.m_upstream_bytes, venus::slab_resource::slab_size);
+}
+
+TEST(memory_resource, polymorphic_allocator)
+{
+    venus::slab_resource slab;
+    {
+        using allocator_t = venus::polymorphic_allocator<std::pair<const int, int>>;
+        std::map<int, int, std::less<int>, allocator_t> map{allocator_t(&slab)};
+        for (int i = 0; i < 100; ++i)
+        {
+            map[i] = i;
+        }
+        ASSERT_EQ(slab.stats().m_allocations, 100);
+    }
+    ASSERT_EQ(slab.stats().m_bytes_in_use, 0);
+}
+
+TEST(memory_resource, unique_task_from_resource)
+{
+    venus::slab_resource slab;
+    std::array<char, 200> large = {};
+    large[0] = 42;
+    char result = 0;
+    {
+        venus::unique_task task(std::allocator_arg, &slab, [large, &result] { result = large[0]; });
+        venus::unique_task moved(std::move(task));
+        moved();
+        ASSERT_EQ(slab.stats().m_allocations, 1);
+    }
+    ASSERT_EQ(result, 42);
+    ASSERT_EQ(slab.stats().m_bytes_in_use, 0);
+
+    // small callables are still stored inline
+    venus::unique_task small(std::allocator_arg, &slab, [&result] { result = 0; });
+    ASSERT_EQ(slab.stats().m_allocations, 1);
+}
+
+// once the working set is reached, tasks and scheduled calls do not allocate from the upstream resource anymore
+TEST(memory_resource, executor_steady_state)
+{
+    venus::executor_options options;
+    options.m_memory_resource = venus::new_delete_resource();
+    venus::executor executor(options);
+    ASSERT_EQ(executor.arena(), executor.arena());
+    ASSERT_NE(executor.arena(), nullptr);
+
+    auto round = [&] {
+        // the executor thread is blocked, so all tasks are queued at the same time in every round
+        std::promise<void> release;
+        auto released = release.get_future().share();
+        executor.add([released] { released.wait(); });
+        for (int i = 0; i < 1000; ++i)
+        {
+            executor.add([] {});
+        }
+        release.set_value();
+
+        executor.call([&] {
+            std::vector<venus::scheduled_call> calls;
+            for (int i = 0; i < 100; ++i)
+            {
+                calls.push_back(executor.call_after(1h, [] {}));
+            }
+            for (auto & call : calls)
+            {
+                call.cancel();
+            }
+        });
+        executor.synchronize();
+    };
+
+    round();
+    auto warm = executor.stats().m_memory;
+    ASSERT_GT(warm.m_upstream_allocations, 0);
+
+    round();
+    round();
+    auto steady = executor.stats().m_memory;
+    ASSERT_GT(steady.m_allocations, warm.m_allocations + 2000);
+    ASSERT_EQ(steady.m_upstream_allocations, warm.m_upstream_allocations);
+    ASSERT_EQ(steady.m_upstream_bytes, warm.m_upstream_bytes);
+}
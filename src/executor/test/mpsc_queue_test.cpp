@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#include "gmock/gmock.h"
+#include <gtest/gtest.h>
+
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "executor/mpsc_queue.hpp"
+
+TEST(mpsc_queue, queue_order)
+{
+    venus::mpsc_queue<std::string> queue;
+    ASSERT_TRUE(queue.empty());
+    queue.push("one");
+    queue.push("two");
+    queue.push("three");
+    ASSERT_FALSE(queue.empty());
+
+    std::string value;
+    ASSERT_TRUE(queue.try_pop(value));
+    ASSERT_EQ(value, "one");
+    ASSERT_TRUE(queue.try_pop(value));
+    ASSERT_EQ(value, "two");
+    ASSERT_TRUE(queue.try_pop(value));
+    ASSERT_EQ(value, "three");
+    ASSERT_FALSE(queue.try_pop(value));
+    ASSERT_TRUE(queue.empty());
+}
+
+TEST(mpsc_queue, push_range)
+{
+    venus::mpsc_queue<std::string> queue;
+    std::vector<std::string> values = {"one", "two", "three"};
+    queue.push("zero");
+    queue.push_range(std::make_move_iterator(values.begin()), std::make_move_iterator(values.end()));
+    queue.push_range(values.begin(), values.begin());
+
+    std::vector<std::string> popped;
+    std::string value;
+    while (queue.try_pop(value))
+    {
+        popped.push_back(value);
+    }
+    ASSERT_THAT(popped, testing::ElementsAre("zero", "one", "two", "three"));
+}
+
+// an element that fails to copy leaves the queue unchanged, the nodes of the batch built so far are destroyed
+TEST(mpsc_queue, push_range_exception)
+{
+    struct throwing_copy
+    {
+        throwing_copy() = default;
+        throwing_copy(std::shared_ptr<int> value, bool fail) :
+            m_value(std::move(value)),
+            m_fail(fail)
+        {
+        }
+
+        throwing_copy(const throwing_copy & other) :
+            m_value(other.m_value),
+            m_fail(other.m_fail)
+        {
+            if (m_fail)
+            {
+                throw std::runtime_error("copy");
+            }
+        }
+
+        throwing_copy(throwing_copy &&) noexcept = default;
+        throwing_copy & operator=(throwing_copy &&) noexcept = default;
+
+        std::shared_ptr<int> m_value;
+        bool m_fail = false;
+    };
+
+    auto value = std::make_shared<int>(1);
+    std::vector<throwing_copy> values;
+    values.emplace_back(value, false);
+    values.emplace_back(value, false);
+    values.emplace_back(value, true);
+
+    venus::mpsc_queue<throwing_copy> queue;
+    ASSERT_THROW(queue.push_range(values.begin(), values.end()), std::runtime_error);
+    ASSERT_EQ(value.use_count(), 4);
+    ASSERT_TRUE(queue.empty());
+
+    values.pop_back();
+    queue.push_range(values.begin(), values.end());
+    throwing_copy popped;
+    ASSERT_TRUE(queue.try_pop(popped));
+    ASSERT_TRUE(queue.try_pop(popped));
+    ASSERT_FALSE(queue.try_pop(popped));
+}
+
+TEST(mpsc_queue, destroys_remaining_values)
+{
+    auto value = std::make_shared<int>(1);
+    {
+        venus::mpsc_queue<std::shared_ptr<int>> queue;
+        queue.push(value);
+        queue.push(value);
+        ASSERT_EQ(value.use_count(), 3);
+    }
+    ASSERT_EQ(value.use_count(), 1);
+}
+
+// values of every single producer are popped in the order that producer pushed them
+TEST(mpsc_queue, multiple_producers)
+{
+    constexpr int producers = 4;
+    constexpr int count = 10000;
+
+    venus::mpsc_queue<std::pair<int, int>> queue;
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p)
+    {
+        threads.emplace_back([&queue, p] {
+            for (int i = 0; i < count; ++i)
+            {
+                queue.push({p, i});
+            }
+        });
+    }
+
+    std::vector<int> next(producers, 0);
+    int received = 0;
+    std::pair<int, int> value;
+    while (received < producers * count)
+    {
+        if (!queue.try_pop(value))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        ASSERT_EQ(value.second, next[static_cast<std::size_t>(value.first)]++);
+        ++received;
+    }
+
+    for (auto & thread : threads)
+    {
+        thread.join();
+    }
+    ASSERT_TRUE(queue.empty());
+}
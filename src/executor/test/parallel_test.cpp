@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#include "gmock/gmock.h"
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstddef>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "executor/executor.hpp"
+#include "executor/parallel.hpp"
+#include "executor/pool_executor.hpp"
+
+TEST(parallel, parallel_for_indices)
+{
+    venus::pool_executor pool(4);
+    std::vector<std::atomic<int>> visited(1000);
+    venus::parallel_for(pool, std::size_t(0), visited.size(), [&](std::size_t i) { ++visited[i]; });
+    for (auto & count : visited)
+    {
+        ASSERT_EQ(count, 1);
+    }
+}
+
+TEST(parallel, parallel_for_elements)
+{
+    venus::pool_executor pool(4);
+    std::vector<int> values(1000, 1);
+    venus::parallel_for(pool, values.begin(), values.end(), [](int & value) { value *= 3; }, 7);
+    ASSERT_EQ(std::accumulate(values.begin(), values.end(), 0), 3000);
+}
+
+TEST(parallel, empty_range)
+{
+    venus::pool_executor pool(2);
+    std::vector<int> values;
+    venus::parallel_for(pool, values.begin(), values.end(), [](int &) { FAIL(); });
+    ASSERT_EQ(venus::parallel_reduce(pool, values.begin(), values.end(), 5, [](int a, int b) { return a + b; }), 5);
+}
+
+TEST(parallel, parallel_transform)
+{
+    venus::pool_executor pool(4);
+    std::vector<int> values(1000);
+    std::iota(values.begin(), values.end(), 0);
+    std::vector<std::string> strings(values.size());
+    auto last = venus::parallel_transform(pool, values.begin(), values.end(), strings.begin(), [](int value) { return std::to_string(value); });
+    ASSERT_EQ(last, strings.end());
+    ASSERT_EQ(strings[0], "0");
+    ASSERT_EQ(strings[999], "999");
+}
+
+// partial results are combined in the order of the chunks, a non-commutative reduction gives the sequential result
+TEST(parallel, parallel_reduce_keeps_order)
+{
+    venus::pool_executor pool(4);
+    std::vector<std::string> letters;
+    for (char c = 'a'; c <= 'z'; ++c)
+    {
+        letters.emplace_back(1, c);
+    }
+    auto joined = venus::parallel_reduce(pool, letters.begin(), letters.end(), std::string(">"), [](std::string a, const std::string & b) { return a + b; }, 3);
+    ASSERT_EQ(joined, ">abcdefghijklmnopqrstuvwxyz");
+}
+
+TEST(parallel, exception_propagates)
+{
+    venus::pool_executor pool(4);
+    std::atomic<int> calls = {0};
+    ASSERT_THROW(venus::parallel_for(pool, 0, 1000, [&](int i) {
+        ++calls;
+        if (i == 500)
+        {
+            throw std::runtime_error("500");
+        }
+    }),
+        std::runtime_error);
+    ASSERT_GE(calls, 1);
+}
+
+// the gather step: the result is delivered to the single thread executor without blocking a thread
+TEST(parallel, result_on_executor)
+{
+    venus::executor executor;
+    venus::pool_executor pool(4);
+    std::vector<long long> values(10000);
+    std::iota(values.begin(), values.end(), 1);
+
+    auto result = venus::parallel_reduce_async(pool, values.begin(), values.end(), 0LL, [](long long a, long long b) { return a + b; })
+                      .then(executor, [&](long long sum) {
+                          EXPECT_TRUE(executor.is_executor_thread());
+                          return sum;
+                      });
+    ASSERT_EQ(result.get(), 50005000LL);
+}
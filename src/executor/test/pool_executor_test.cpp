@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#include "gmock/gmock.h"
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <future>
+#include <numeric>
+#include <vector>
+
+#include "executor/executor.hpp"
+#include "executor/pool_executor.hpp"
+
+using namespace std::chrono_literals;
+
+TEST(pool_executor, construction_destruction)
+{
+    venus::pool_executor pool(4);
+    ASSERT_EQ(pool.thread_count(), 4);
+    ASSERT_FALSE(pool.is_pool_thread());
+}
+
+TEST(pool_executor, default_thread_count)
+{
+    venus::pool_executor pool;
+    ASSERT_GE(pool.thread_count(), 1);
+}
+
+TEST(pool_executor, call)
+{
+    venus::pool_executor pool(2);
+    ASSERT_EQ(pool.call([] { return 42; }), 42);
+    ASSERT_TRUE(pool.call([&] { return pool.is_pool_thread(); }));
+}
+
+TEST(pool_executor, call_async)
+{
+    venus::pool_executor pool(2);
+    std::vector<std::future<int>> futures;
+    for (int i = 0; i < 100; ++i)
+    {
+        futures.push_back(pool.call_async([i] { return i * i; }));
+    }
+
+    int sum = 0;
+    for (auto & future : futures)
+    {
+        sum += future.get();
+    }
+    ASSERT_EQ(sum, 328350);
+}
+
+// the destructor completes all added tasks, including tasks added by tasks (which go onto the local deque)
+TEST(pool_executor, destructor_completes_nested_tasks)
+{
+    std::atomic<int> count(0);
+    {
+        venus::pool_executor pool(3);
+        for (int i = 0; i < 10; ++i)
+        {
+            pool.add([&] {
+                for (int j = 0; j < 100; ++j)
+                {
+                    pool.add([&] { ++count; });
+                }
+            });
+        }
+    }
+    ASSERT_EQ(count, 1000);
+}
+
+// scatter work on the pool, gather the results on a single thread executor
+TEST(pool_executor, scatter_gather)
+{
+    venus::executor executor;
+    std::vector<int> results;
+    std::promise<void> done;
+    {
+        venus::pool_executor pool(4);
+        for (int i = 0; i < 64; ++i)
+        {
+            pool.add([&, i] {
+                auto value = i * 2;
+                executor.add([&, value] {
+                    results.push_back(value);
+                    if (results.size() == 64)
+                    {
+                        done.set_value();
+                    }
+                });
+            });
+        }
+        done.get_future().wait();
+    }
+
+    ASSERT_EQ(std::accumulate(results.begin(), results.end(), 0), 4032);
+}
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#include "gmock/gmock.h"
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "executor/executor.hpp"
+#include "executor/reactor.hpp"
+
+#if defined(__linux__)
+
+#include <sys/epoll.h>
+#include <unistd.h>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+venus::executor_options reactor_mode()
+{
+    venus::executor_options options;
+    options.m_reactor = true;
+    return options;
+}
+
+struct pipe_fds
+{
+    pipe_fds()
+    {
+        EXPECT_EQ(pipe(m_fds), 0);
+    }
+
+    ~pipe_fds()
+    {
+        close(m_fds[0]);
+        close(m_fds[1]);
+    }
+
+    int read_end() const
+    {
+        return m_fds[0];
+    }
+
+    void write(const std::string & data) const
+    {
+        EXPECT_EQ(::write(m_fds[1], data.data(), data.size()), static_cast<ssize_t>(data.size()));
+    }
+
+    int m_fds[2] = {-1, -1};
+};
+
+std::string read_all(int fd)
+{
+    char buffer[256];
+    auto count = ::read(fd, buffer, sizeof(buffer));
+    return count > 0 ? std::string(buffer, static_cast<std::size_t>(count)) : std::string();
+}
+
+} // namespace
+
+TEST(reactor, wake_and_timeout)
+{
+    venus::reactor reactor;
+    std::atomic<bool> ready = {false};
+    ASSERT_FALSE(reactor.wait_until([&] { return ready.load(); }, venus::clock_t::now() + 10ms));
+
+    std::thread producer([&] {
+        std::this_thread::sleep_for(10ms);
+        ready = true;
+        reactor.wake();
+    });
+    reactor.wait([&] { return ready.load(); });
+    ASSERT_TRUE(ready);
+    producer.join();
+}
+
+TEST(reactor, executor_dispatches_fd_callbacks_inline)
+{
+    venus::executor executor(reactor_mode());
+    pipe_fds fds;
+    std::promise<std::string> received;
+    executor.watch(fds.read_end(), EPOLLIN, [&](std::uint32_t events) {
+        EXPECT_TRUE(executor.is_executor_thread());
+        EXPECT_TRUE((events & EPOLLIN) != 0);
+        received.set_value(read_all(fds.read_end()));
+        executor.unwatch(fds.read_end());
+    });
+
+    fds.write("hello");
+    ASSERT_EQ(received.get_future().get(), "hello");
+    executor.unwatch(fds.read_end());
+}
+
+TEST(reactor, executor_tasks_and_timers)
+{
+    venus::executor executor(reactor_mode());
+    ASSERT_EQ(executor.call([] { return 42; }), 42);
+
+    auto start = std::chrono::steady_clock::now();
+    std::promise<std::chrono::steady_clock::duration> fired;
+    executor.call_after(20ms, [&] { fired.set_value(std::chrono::steady_clock::now() - start); });
+    ASSERT_GE(fired.get_future().get(), 20ms);
+
+    std::atomic<int> count = {0};
+    for (int i = 0; i < 10000; ++i)
+    {
+        executor.add([&] { ++count; });
+    }
+    executor.synchronize();
+    ASSERT_EQ(count, 10000);
+}
+
+// a steady stream of tasks does not keep the executor from reading its file descriptors
+TEST(reactor, busy_executor_still_polls)
+{
+    venus::executor executor(reactor_mode());
+    pipe_fds fds;
+    std::atomic<bool> received = {false};
+    executor.watch(fds.read_end(), EPOLLIN, [&](std::uint32_t) {
+        read_all(fds.read_end());
+        received = true;
+    });
+
+    std::function<void()> spin = [&] {
+        if (!received)
+        {
+            executor.add([&] { spin(); });
+        }
+    };
+    executor.add([&] { spin(); });
+    fds.write("x");
+    executor.synchronize();
+    while (!received)
+    {
+        std::this_thread::sleep_for(1ms);
+    }
+    executor.unwatch(fds.read_end());
+    executor.synchronize();
+}
+
+TEST(reactor, watch_requires_reactor_mode)
+{
+    venus::executor executor;
+    pipe_fds fds;
+    ASSERT_THROW(executor.watch(fds.read_end(), EPOLLIN, [](std::uint32_t) {}), std::logic_error);
+}
+
+#endif
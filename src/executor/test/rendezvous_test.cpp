@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#include "gmock/gmock.h"
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "executor/executor.hpp"
+#include "executor/pool_executor.hpp"
+#include "executor/rendezvous.hpp"
+#include "executor/strand.hpp"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+// counts its copies and moves, so the tests can check how a result travels back to the caller
+struct counted
+{
+    explicit counted(int value) :
+        m_value(value)
+    {
+    }
+
+    counted(const counted & other) :
+        m_value(other.m_value),
+        m_copies(other.m_copies + 1),
+        m_moves(other.m_moves)
+    {
+    }
+
+    counted(counted && other) noexcept :
+        m_value(other.m_value),
+        m_copies(other.m_copies),
+        m_moves(other.m_moves + 1)
+    {
+    }
+
+    int m_value;
+    int m_copies = 0;
+    int m_moves = 0;
+};
+
+} // namespace
+
+// the waiter is long past spinning when set() is called, so it sleeps and must be woken up
+TEST(rendezvous, event_wakes_sleeping_waiter)
+{
+    for (int i = 0; i < 10; ++i)
+    {
+        venus::detail::event done;
+        std::thread setter([&] {
+            std::this_thread::sleep_for(5ms);
+            done.set();
+        });
+        done.wait();
+        setter.join();
+    }
+
+    venus::detail::event ready;
+    ready.set();
+    ready.wait();
+}
+
+TEST(rendezvous, result_is_moved_not_copied)
+{
+    venus::executor executor;
+    auto result = executor.call([] { return counted(42); });
+    ASSERT_EQ(result.m_value, 42);
+    ASSERT_EQ(result.m_copies, 0);
+
+    auto text = executor.call([] { return std::string(1000, 'x'); });
+    ASSERT_EQ(text.size(), 1000);
+}
+
+TEST(rendezvous, move_only_result_and_callable)
+{
+    venus::executor executor;
+    auto value = std::make_unique<int>(42);
+    auto take = [value = std::move(value)]() mutable { return std::move(value); };
+    auto result = executor.call(std::move(take));
+    ASSERT_EQ(*result, 42);
+}
+
+// call() takes the callable by reference, a stateful callable is changed in place
+TEST(rendezvous, callable_is_not_copied)
+{
+    venus::executor executor;
+    struct counter
+    {
+        counter() = default;
+        counter(const counter &) = delete;
+        counter & operator=(const counter &) = delete;
+
+        int operator()()
+        {
+            return ++m_calls;
+        }
+
+        int m_calls = 0;
+    } count;
+
+    ASSERT_EQ(executor.call(count), 1);
+    ASSERT_EQ(executor.call(count), 2);
+    ASSERT_EQ(count.m_calls, 2);
+}
+
+TEST(rendezvous, reference_result)
+{
+    venus::executor executor;
+    int value = 0;
+    // call() returns by value, as it did with a std::future<int &>
+    auto copy = executor.call([&]() -> int & { return value; });
+    ASSERT_EQ(copy, 0);
+
+    venus::detail::rendezvous<int &> done;
+    auto fn = [&]() -> int & { return value; };
+    executor.add([&] { done.run(fn); });
+    done.get() = 42;
+    ASSERT_EQ(value, 42);
+}
+
+TEST(rendezvous, exceptions_are_rethrown)
+{
+    venus::executor executor;
+    ASSERT_THROW(executor.call([]() -> counted { throw std::runtime_error("value"); }), std::runtime_error);
+    ASSERT_THROW(executor.call([] { throw std::logic_error("void"); }), std::logic_error);
+
+    venus::pool_executor pool(2);
+    venus::strand strand(pool);
+    ASSERT_THROW(pool.call([] { throw std::runtime_error("pool"); }), std::runtime_error);
+    ASSERT_THROW(strand.call([]() -> int { throw std::runtime_error("strand"); }), std::runtime_error);
+    ASSERT_EQ(strand.call([] { return 42; }), 42);
+}
+
+// a call() does not allocate from the arena beyond the queue node of its task
+TEST(rendezvous, call_allocates_one_queue_node)
+{
+    venus::executor_options options;
+    options.m_memory_resource = venus::new_delete_resource();
+    venus::executor executor(options);
+    executor.call([] {});
+
+    auto before = executor.stats().m_memory;
+    for (int i = 0; i < 100; ++i)
+    {
+        executor.call([i] { return counted(i); });
+    }
+    executor.synchronize();
+    auto after = executor.stats().m_memory;
+    ASSERT_EQ(after.m_allocations - before.m_allocations, 100 + venus::priority_count);
+    ASSERT_EQ(after.m_upstream_allocations, before.m_upstream_allocations);
+}
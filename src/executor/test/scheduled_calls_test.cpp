@@ -0,0 +1,339 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#include "gmock/gmock.h"
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "executor/scheduled_calls.hpp"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+venus::time_point_t at(venus::duration_t offset)
+{
+    return venus::time_point_t() + 1h + offset;
+}
+
+std::vector<venus::call_t::id_t> pop_all(venus::scheduled_calls & calls)
+{
+    std::vector<venus::call_t::id_t> ids;
+    while (!calls.empty())
+    {
+        auto deadline = calls.next_deadline();
+        auto call = calls.pop_and_reschedule();
+        EXPECT_EQ(call.m_at, deadline);
+        ids.push_back(call.m_id);
+    }
+    return ids;
+}
+
+} // namespace
+
+TEST(scheduled_calls, ordering)
+{
+    venus::scheduled_calls calls;
+    ASSERT_TRUE(calls.empty());
+    calls.insert(venus::call_t(1, at(5min), {}));
+    calls.insert(venus::call_t(2, at(1ms), {}));
+    calls.insert(venus::call_t(3, at(100h), {}));
+    calls.insert(venus::call_t(4, at(1us), {}));
+    calls.insert(venus::call_t(5, at(2s), {}));
+    ASSERT_EQ(calls.size(), 5);
+    ASSERT_EQ(calls.next_deadline(), at(1us));
+
+    ASSERT_THAT(pop_all(calls), testing::ElementsAre(4, 2, 5, 1, 3));
+}
+
+// calls with identical deadlines are popped in the order they were inserted
+TEST(scheduled_calls, identical_deadlines)
+{
+    venus::scheduled_calls calls;
+    calls.insert(venus::call_t(1, at(10s), {}));
+    calls.insert(venus::call_t(2, at(1ms), {}));
+    calls.insert(venus::call_t(3, at(10s), {}));
+    calls.insert(venus::call_t(4, at(1ms), {}));
+    calls.insert(venus::call_t(5, at(10s), {}));
+
+    ASSERT_THAT(pop_all(calls), testing::ElementsAre(2, 4, 1, 3, 5));
+}
+
+TEST(scheduled_calls, extreme_deadlines)
+{
+    venus::scheduled_calls calls;
+    calls.insert(venus::call_t(1, venus::time_point_t::max(), {}));
+    calls.insert(venus::call_t(2, venus::time_point_t::min(), {}));
+    calls.insert(venus::call_t(3, venus::time_point_t(), {}));
+
+    ASSERT_THAT(pop_all(calls), testing::ElementsAre(2, 3, 1));
+}
+
+TEST(scheduled_calls, remove)
+{
+    venus::scheduled_calls calls;
+    calls.insert(venus::call_t(1, at(1ms), {}));
+    calls.insert(venus::call_t(2, at(2ms), {}));
+    calls.insert(venus::call_t(3, at(3h), {}));
+    calls.remove(1);
+    calls.remove(3);
+    calls.remove(42);
+    ASSERT_EQ(calls.size(), 1);
+    ASSERT_EQ(calls.next_deadline(), at(2ms));
+    ASSERT_THAT(pop_all(calls), testing::ElementsAre(2));
+}
+
+// ids of venus::call_handles re-use a slot (the low 32 bits) with a new generation, an old id does not find the new call
+TEST(scheduled_calls, id_generations)
+{
+    constexpr venus::call_t::id_t first_generation = (venus::call_t::id_t(1) << 32) | 7;
+    constexpr venus::call_t::id_t second_generation = (venus::call_t::id_t(2) << 32) | 7;
+
+    venus::scheduled_calls calls;
+    calls.insert(venus::call_t(first_generation, at(1ms), {}));
+    ASSERT_TRUE(calls.remove(first_generation));
+    calls.insert(venus::call_t(second_generation, at(2ms), {}));
+    ASSERT_FALSE(calls.remove(first_generation));
+    ASSERT_FALSE(calls.remove(7));
+    ASSERT_EQ(calls.size(), 1);
+    ASSERT_THAT(pop_all(calls), testing::ElementsAre(second_generation));
+}
+
+// the index is keyed on the full id: ids that only differ in their high bits are scheduled at the same time
+TEST(scheduled_calls, any_ids)
+{
+    constexpr venus::call_t::id_t high = venus::call_t::id_t(1) << 32;
+
+    venus::scheduled_calls calls;
+    for (venus::call_t::id_t id = 1; id <= 100; ++id)
+    {
+        calls.insert(venus::call_t(id, at(std::chrono::milliseconds(id)), {}));
+        calls.insert(venus::call_t(id | high, at(std::chrono::milliseconds(id) + 1us), {}));
+    }
+    for (venus::call_t::id_t id = 1; id <= 100; id += 2)
+    {
+        ASSERT_TRUE(calls.remove(id | high));
+        ASSERT_FALSE(calls.remove(id | high));
+    }
+    ASSERT_EQ(calls.size(), 150);
+
+    std::vector<venus::call_t::id_t> expected;
+    for (venus::call_t::id_t id = 1; id <= 100; ++id)
+    {
+        expected.push_back(id);
+        if (id % 2 == 0)
+        {
+            expected.push_back(id | high);
+        }
+    }
+    ASSERT_EQ(pop_all(calls), expected);
+}
+
+// increasing ids, like those of make_callid(), with a single live call do not grow the index
+TEST(scheduled_calls, increasing_ids)
+{
+    venus::slab_resource resource;
+    venus::scheduled_calls calls(&resource);
+    for (venus::call_t::id_t id = 1; id <= 100000; ++id)
+    {
+        calls.insert(venus::call_t(id, at(1ms), {}));
+        if (id % 2 == 0)
+        {
+            ASSERT_TRUE(calls.remove(id));
+        }
+        else
+        {
+            ASSERT_EQ(calls.pop_and_reschedule().m_id, id);
+        }
+    }
+    ASSERT_TRUE(calls.empty());
+    ASSERT_LT(resource.stats().m_bytes_in_use, 4096);
+}
+
+TEST(scheduled_calls, reschedule_and_restore)
+{
+    venus::scheduled_calls calls;
+    int count = 0;
+    calls.insert(venus::call_t(1, at(0ms), 10ms, [&] { ++count; }));
+    calls.insert(venus::call_t(2, at(25ms), {}));
+
+    std::vector<venus::call_t::id_t> ids;
+    for (int i = 0; i < 5; ++i)
+    {
+        auto call = calls.pop_and_reschedule();
+        ids.push_back(call.m_id);
+        if (call.m_function)
+        {
+            call.m_function();
+        }
+        calls.restore(std::move(call));
+    }
+
+    ASSERT_THAT(ids, testing::ElementsAre(1, 1, 1, 2, 1));
+    ASSERT_EQ(count, 4);
+    ASSERT_EQ(calls.next_deadline(), at(40ms));
+
+    calls.remove(1);
+    ASSERT_TRUE(calls.empty());
+}
+
+// random deadlines and removes, compared with a stable sort of the remaining calls
+TEST(scheduled_calls, random)
+{
+    struct reference_call
+    {
+        venus::call_t::id_t m_id;
+        venus::time_point_t m_at;
+    };
+
+    std::mt19937 random(1234);
+    std::uniform_int_distribution<std::int64_t> microseconds(0, 100'000'000);
+
+    venus::scheduled_calls calls;
+    std::vector<reference_call> reference;
+    for (venus::call_t::id_t id = 1; id <= 20000; ++id)
+    {
+        // a coarse deadline causes many identical deadlines
+        auto deadline = at(std::chrono::microseconds(id % 3 == 0 ? microseconds(random) / 1000 * 1000 : microseconds(random)));
+        calls.insert(venus::call_t(id, deadline, {}));
+        reference.push_back({id, deadline});
+    }
+
+    for (venus::call_t::id_t id = 1; id <= 20000; id += 7)
+    {
+        calls.remove(id);
+    }
+    reference.erase(std::remove_if(reference.begin(), reference.end(), [](const reference_call & call) { return (call.m_id - 1) % 7 == 0; }), reference.end());
+    std::stable_sort(reference.begin(), reference.end(), [](const reference_call & a, const reference_call & b) { return a.m_at < b.m_at; });
+
+    std::vector<venus::call_t::id_t> expected;
+    for (auto & call : reference)
+    {
+        expected.push_back(call.m_id);
+    }
+    ASSERT_EQ(calls.size(), expected.size());
+    ASSERT_EQ(pop_all(calls), expected);
+}
+
+// inserts between pops land relative to the current tick of the wheel, also in the past
+TEST(scheduled_calls, interleaved)
+{
+    struct reference_call
+    {
+        venus::time_point_t m_at;
+        std::uint64_t m_sequence;
+        venus::call_t::id_t m_id;
+    };
+
+    std::mt19937 random(4321);
+    std::uniform_int_distribution<std::int64_t> microseconds(-10'000, 10'000'000);
+
+    venus::scheduled_calls calls;
+    std::vector<reference_call> reference;
+    auto earlier = [](const reference_call & a, const reference_call & b) {
+        return a.m_at > b.m_at || (a.m_at == b.m_at && a.m_sequence > b.m_sequence);
+    };
+
+    venus::call_t::id_t id = 0;
+    auto now = at(0s);
+    for (int round = 0; round < 200; ++round)
+    {
+        for (int i = 0; i < 50; ++i)
+        {
+            ++id;
+            auto deadline = now + std::chrono::microseconds(microseconds(random));
+            calls.insert(venus::call_t(id, deadline, {}));
+            reference.push_back({deadline, id, id});
+            std::push_heap(reference.begin(), reference.end(), earlier);
+        }
+
+        for (int i = 0; i < 40; ++i)
+        {
+            std::pop_heap(reference.begin(), reference.end(), earlier);
+            auto expected = reference.back();
+            reference.pop_back();
+
+            ASSERT_EQ(calls.next_deadline(), expected.m_at);
+            ASSERT_EQ(calls.pop_and_reschedule().m_id, expected.m_id);
+            now = std::max(now, expected.m_at);
+        }
+    }
+    ASSERT_EQ(calls.size(), reference.size());
+}
+
+TEST(scheduled_calls, coalesce)
+{
+    ASSERT_EQ(venus::coalesce(at(1234567ns), 0ns), at(1234567ns));
+    ASSERT_EQ(venus::coalesce(at(1000ns), 1000ns) - at(0ns), 1024ns); // granularity 512ns
+    ASSERT_EQ(venus::coalesce(at(1024ns), 1000ns), at(1024ns));
+    ASSERT_EQ(venus::coalesce(venus::time_point_t(-1000ns), 1000ns), venus::time_point_t(-1024ns + 512ns));
+
+    // never earlier, never later than at + slack
+    std::mt19937 random(99);
+    std::uniform_int_distribution<std::int64_t> nanoseconds(0, 10'000'000'000);
+    for (int i = 0; i < 1000; ++i)
+    {
+        auto deadline = at(std::chrono::nanoseconds(nanoseconds(random)));
+        auto slack = std::chrono::nanoseconds(nanoseconds(random) / 1000);
+        auto coalesced = venus::coalesce(deadline, slack);
+        ASSERT_GE(coalesced, deadline);
+        ASSERT_LE(coalesced, deadline + slack);
+    }
+}
+
+// calls with a slack are due together, a repeating call is rescheduled from its own deadline, so it does not drift
+TEST(scheduled_calls, slack)
+{
+    venus::scheduled_calls calls;
+    calls.insert(venus::call_t(1, at(100ms + 10us), {}, 10ms, {}));
+    calls.insert(venus::call_t(2, at(100ms + 900us), {}, 10ms, {}));
+    calls.insert(venus::call_t(3, at(100ms + 500us), 10ms, 1ms, {}));
+
+    auto first = calls.pop_and_reschedule();
+    ASSERT_EQ(first.m_id, 3);
+    ASSERT_EQ(first.due(), venus::coalesce(at(100ms + 500us), 1ms));
+    calls.restore(std::move(first));
+
+    ASSERT_EQ(calls.next_deadline(), venus::coalesce(at(100ms + 10us), 10ms));
+    ASSERT_EQ(calls.pop_and_reschedule().m_id, 1);
+    ASSERT_EQ(calls.next_deadline(), venus::coalesce(at(100ms + 10us), 10ms));
+    ASSERT_EQ(calls.pop_and_reschedule().m_id, 2);
+
+    auto repeated = calls.pop_and_reschedule();
+    ASSERT_EQ(repeated.m_id, 3);
+    ASSERT_EQ(repeated.m_at, at(110ms + 500us));
+}
+
+// a repeating call that ran until 35ms past its deadline, with a 10ms interval, missed the ticks at 10, 20 and 30ms
+TEST(scheduled_calls, missed_tick_policies)
+{
+    auto run_late = [](venus::missed_tick_policy policy) {
+        venus::scheduled_calls calls;
+        venus::call_t call(1, at(0ms), 10ms, {}, [] {});
+        call.m_missed_policy = policy;
+        calls.insert(std::move(call));
+
+        auto first = calls.pop_and_reschedule();
+        EXPECT_EQ(first.m_missed, 0);
+        calls.restore(std::move(first), at(35ms));
+        return calls.pop_and_reschedule();
+    };
+
+    auto catch_up = run_late(venus::missed_tick_policy::catch_up);
+    ASSERT_EQ(catch_up.m_at, at(10ms));
+    ASSERT_EQ(catch_up.m_missed, 0);
+
+    auto skip = run_late(venus::missed_tick_policy::skip);
+    ASSERT_EQ(skip.m_at, at(40ms));
+    ASSERT_EQ(skip.m_missed, 3);
+
+    auto coalesce = run_late(venus::missed_tick_policy::coalesce);
+    ASSERT_EQ(coalesce.m_at, at(30ms));
+    ASSERT_EQ(coalesce.m_missed, 2);
+    ASSERT_TRUE(coalesce.m_function);
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#include "gmock/gmock.h"
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "executor/pool_executor.hpp"
+#include "executor/strand.hpp"
+
+TEST(strand, call)
+{
+    venus::pool_executor pool(2);
+    venus::strand strand(pool);
+    ASSERT_FALSE(strand.is_current_strand());
+    ASSERT_EQ(strand.call([] { return 42; }), 42);
+    ASSERT_TRUE(strand.call([&] { return strand.is_current_strand() && pool.is_pool_thread(); }));
+}
+
+// tasks from several producers run in the order each producer added them, and never at the same time
+TEST(strand, fifo_and_never_concurrent)
+{
+    venus::pool_executor pool(4);
+    venus::strand strand(pool);
+
+    constexpr int producers = 4;
+    constexpr int tasks = 5000;
+    std::atomic<int> running(0);
+    bool overlapped = false;
+    std::vector<std::vector<int>> received(producers);
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p)
+    {
+        threads.emplace_back([&, p] {
+            for (int i = 0; i < tasks; ++i)
+            {
+                strand.add([&, p, i] {
+                    overlapped |= running.fetch_add(1) != 0;
+                    received[static_cast<std::size_t>(p)].push_back(i);
+                    running.fetch_sub(1);
+                });
+            }
+        });
+    }
+    for (auto & thread : threads)
+    {
+        thread.join();
+    }
+    strand.synchronize();
+
+    ASSERT_FALSE(overlapped);
+    for (auto & values : received)
+    {
+        ASSERT_EQ(values.size(), tasks);
+        ASSERT_TRUE(std::is_sorted(values.begin(), values.end()));
+    }
+}
+
+// many strands share a small pool, and hand work to each other
+TEST(strand, many_strands)
+{
+    venus::pool_executor pool(2);
+    std::vector<std::unique_ptr<venus::strand>> strands;
+    std::vector<int> counts(10000, 0);
+    for (std::size_t i = 0; i < counts.size(); ++i)
+    {
+        strands.push_back(std::make_unique<venus::strand>(pool));
+    }
+
+    for (std::size_t i = 0; i < counts.size(); ++i)
+    {
+        strands[i]->add([&, i] {
+            ++counts[i];
+            auto next = (i + 1) % counts.size();
+            strands[next]->add([&, next] { ++counts[next]; });
+        });
+    }
+
+    // the first round runs the first tasks, which add the second ones, the second round runs those
+    for (int round = 0; round < 2; ++round)
+    {
+        for (auto & strand : strands)
+        {
+            strand->synchronize();
+        }
+    }
+    ASSERT_THAT(counts, testing::Each(2));
+}
+
+TEST(strand, exceptions_are_ignored)
+{
+    venus::pool_executor pool(1);
+    venus::strand strand(pool);
+    strand.add([] { throw std::runtime_error("ignored"); });
+    ASSERT_EQ(strand.call([] { return 1; }), 1);
+}
+
+TEST(strand, destructor_completes_tasks)
+{
+    venus::pool_executor pool(2);
+    int count = 0;
+    {
+        venus::strand strand(pool);
+        for (int i = 0; i < 1000; ++i)
+        {
+            strand.add([&] { ++count; });
+        }
+    }
+    ASSERT_EQ(count, 1000);
+}
@@ -10,6 +10,7 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "executor/synchronized_queue.hpp"
@@ -63,3 +64,137 @@ TEST(synchronized_queue, queue_order)
     ASSERT_EQ(synchronous_string_q.size(), 0);
     ASSERT_TRUE(synchronous_string_q.empty());
 }
+
+TEST(synchronized_queue, push_range_pop_all)
+{
+    venus::synchronized_queue<std::string> synchronous_string_q;
+    std::vector<std::string> values = {"one", "two", "three"};
+    synchronous_string_q.push_range(values.begin(), values.end());
+    synchronous_string_q.push("four");
+    ASSERT_EQ(synchronous_string_q.size(), 4);
+
+    auto all = synchronous_string_q.pop_all();
+    ASSERT_THAT(all, testing::ElementsAre("one", "two", "three", "four"));
+    ASSERT_TRUE(synchronous_string_q.empty());
+}
+
+// a range larger than the maximum_size is pushed in parts, as the consumer makes room
+TEST(synchronized_queue, push_range_maximum_size)
+{
+    venus::synchronized_queue<int> synchronous_int_q(2);
+    std::vector<int> values = {1, 2, 3, 4, 5};
+
+    std::vector<int> received;
+    std::thread consumer([&] {
+        while (received.size() < values.size())
+        {
+            for (auto value : synchronous_int_q.pop_all())
+            {
+                received.push_back(value);
+            }
+        }
+    });
+
+    synchronous_int_q.push_range(values.begin(), values.end());
+    consumer.join();
+    ASSERT_EQ(received, values);
+}
+
+TEST(synchronized_queue, try_push_try_pop)
+{
+    venus::synchronized_queue<int> synchronous_int_q(2);
+    int value = 0;
+    ASSERT_FALSE(synchronous_int_q.try_pop(value));
+    ASSERT_TRUE(synchronous_int_q.try_push(1));
+    ASSERT_TRUE(synchronous_int_q.try_push(2));
+    ASSERT_FALSE(synchronous_int_q.try_push(3));
+    ASSERT_EQ(synchronous_int_q.rejected_count(), 1);
+
+    ASSERT_TRUE(synchronous_int_q.try_pop(value));
+    ASSERT_EQ(value, 1);
+    ASSERT_TRUE(synchronous_int_q.try_pop(value));
+    ASSERT_EQ(value, 2);
+    ASSERT_TRUE(synchronous_int_q.empty());
+}
+
+TEST(synchronized_queue, timed_push_pop)
+{
+    venus::synchronized_queue<int> synchronous_int_q(1);
+    int value = 0;
+    ASSERT_FALSE(synchronous_int_q.pop_for(value, 10ms));
+    ASSERT_TRUE(synchronous_int_q.push_for(1, 10ms));
+    ASSERT_FALSE(synchronous_int_q.push_for(2, 10ms));
+    ASSERT_EQ(synchronous_int_q.rejected_count(), 1);
+    ASSERT_FALSE(synchronous_int_q.wait_for_not_full(10ms));
+
+    std::thread consumer([&] { ASSERT_EQ(synchronous_int_q.pop(), 1); });
+    ASSERT_TRUE(synchronous_int_q.push_until(3, std::chrono::steady_clock::now() + 10s));
+    consumer.join();
+    ASSERT_TRUE(synchronous_int_q.pop_until(value, std::chrono::steady_clock::now() + 10s));
+    ASSERT_EQ(value, 3);
+}
+
+TEST(synchronized_queue, overflow_policies)
+{
+    venus::synchronized_queue<int> reject_q(2, venus::overflow_policy::reject);
+    venus::synchronized_queue<int> drop_oldest_q(2, venus::overflow_policy::drop_oldest);
+    venus::synchronized_queue<int> drop_newest_q(2, venus::overflow_policy::drop_newest);
+    std::vector<int> values = {1, 2, 3, 4};
+    for (auto value : values)
+    {
+        reject_q.push(value);
+        drop_oldest_q.push(value);
+    }
+    ASSERT_EQ(drop_newest_q.push_range(values.begin(), values.end()), 2);
+
+    ASSERT_THAT(reject_q.pop_all(), testing::ElementsAre(1, 2));
+    ASSERT_EQ(reject_q.rejected_count(), 2);
+    ASSERT_EQ(reject_q.dropped_count(), 0);
+    ASSERT_THAT(drop_oldest_q.pop_all(), testing::ElementsAre(3, 4));
+    ASSERT_EQ(drop_oldest_q.dropped_count(), 2);
+    ASSERT_THAT(drop_newest_q.pop_all(), testing::ElementsAre(1, 2));
+    ASSERT_EQ(drop_newest_q.dropped_count(), 2);
+    ASSERT_EQ(drop_newest_q.rejected_count(), 0);
+}
+
+// an element larger than the maximum_bytes is only accepted by an empty queue
+TEST(synchronized_queue, maximum_bytes)
+{
+    venus::synchronized_queue<std::string> synchronous_string_q(0, 10, [](const std::string & s) { return s.size(); }, venus::overflow_policy::drop_oldest);
+    ASSERT_EQ(synchronous_string_q.maximum_bytes(), 10);
+    synchronous_string_q.push("12345");
+    synchronous_string_q.push("1234");
+    ASSERT_EQ(synchronous_string_q.bytes(), 9);
+    ASSERT_FALSE(synchronous_string_q.full());
+    synchronous_string_q.push("123");
+    ASSERT_EQ(synchronous_string_q.dropped_count(), 1);
+    ASSERT_EQ(synchronous_string_q.bytes(), 7);
+
+    synchronous_string_q.push("this is too large");
+    ASSERT_EQ(synchronous_string_q.size(), 1);
+    ASSERT_TRUE(synchronous_string_q.full());
+    ASSERT_EQ(synchronous_string_q.pop(), "this is too large");
+    ASSERT_EQ(synchronous_string_q.bytes(), 0);
+}
+
+// many blocking handoffs in both directions, a notify that is skipped while a thread sleeps would hang this test
+TEST(synchronized_queue, ping_pong)
+{
+    venus::synchronized_queue<int> ping(1);
+    venus::synchronized_queue<int> pong(1);
+    constexpr int round_trips = 10000;
+
+    std::thread echo([&] {
+        for (int i = 0; i < round_trips; ++i)
+        {
+            pong.push(ping.pop());
+        }
+    });
+
+    for (int i = 0; i < round_trips; ++i)
+    {
+        ping.push(i);
+        ASSERT_EQ(pong.pop(), i);
+    }
+    echo.join();
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#include "gmock/gmock.h"
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <set>
+#include <string>
+#include <system_error>
+
+#include "executor/executor.hpp"
+#include "executor/pool_executor.hpp"
+#include "executor/thread_options.hpp"
+
+#if defined(__linux__)
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+std::string thread_name()
+{
+    char name[16] = {};
+    pthread_getname_np(pthread_self(), name, sizeof(name));
+    return name;
+}
+
+// the first cpu this process may run on, so the tests also work in a restricted container
+std::size_t first_allowed_cpu()
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    sched_getaffinity(0, sizeof(set), &set);
+    for (std::size_t cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+    {
+        if (CPU_ISSET(cpu, &set))
+        {
+            return cpu;
+        }
+    }
+    return 0;
+}
+
+std::size_t allowed_cpu_count()
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    pthread_getaffinity_np(pthread_self(), sizeof(set), &set);
+    return static_cast<std::size_t>(CPU_COUNT(&set));
+}
+
+} // namespace
+
+TEST(thread_options, executor_thread)
+{
+    venus::executor_options options;
+    options.m_thread.m_name = "venus-executor-thread"; // longer than 15 characters
+    options.m_thread.m_cpus = {first_allowed_cpu()};
+    options.m_thread.m_nice = 1;
+    venus::executor executor(options);
+
+    ASSERT_EQ(executor.call([] { return thread_name(); }), "venus-executor-");
+    ASSERT_EQ(executor.call([] { return static_cast<std::size_t>(sched_getcpu()); }), first_allowed_cpu());
+    ASSERT_EQ(executor.call([] { return allowed_cpu_count(); }), 1);
+    ASSERT_EQ(executor.call([] { return getpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid))); }), 1);
+}
+
+TEST(thread_options, pool_workers)
+{
+    venus::pool_options options;
+    options.m_thread_count = 3;
+    options.m_thread.m_name = "pool";
+    options.m_worker_cpus = {first_allowed_cpu()};
+    venus::pool_executor pool(options);
+
+    // whichever worker runs a task, it has the pool name with its own index
+    std::set<std::string> names;
+    for (int i = 0; i < 16; ++i)
+    {
+        names.insert(pool.call_async([] { return thread_name(); }).get());
+    }
+    for (auto & name : names)
+    {
+        ASSERT_THAT(name, testing::AnyOf("pool-0", "pool-1", "pool-2"));
+    }
+    ASSERT_EQ(pool.call_async([] { return allowed_cpu_count(); }).get(), 1);
+}
+
+TEST(thread_options, rejected_options_throw)
+{
+    venus::executor_options invalid_cpu;
+    invalid_cpu.m_thread.m_cpus = {CPU_SETSIZE};
+    ASSERT_THROW(venus::executor executor(invalid_cpu), std::system_error);
+
+    venus::executor_options invalid_priority;
+    invalid_priority.m_thread.m_policy = venus::scheduling_policy::fifo;
+    invalid_priority.m_thread.m_priority = 1000;
+    ASSERT_THROW(venus::executor executor(invalid_priority), std::system_error);
+
+    venus::pool_options invalid_worker;
+    invalid_worker.m_thread_count = 2;
+    invalid_worker.m_worker_cpus = {first_allowed_cpu(), CPU_SETSIZE};
+    ASSERT_THROW(venus::pool_executor pool(invalid_worker), std::system_error);
+}
+
+TEST(thread_options, batch_policy)
+{
+    venus::executor_options options;
+    options.m_thread.m_policy = venus::scheduling_policy::batch;
+    venus::executor executor(options);
+    ASSERT_EQ(executor.call([] { return sched_getscheduler(0); }), SCHED_BATCH);
+}
+
+#endif
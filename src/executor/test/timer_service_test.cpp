@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#include "gmock/gmock.h"
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "executor/executor.hpp"
+#include "executor/timer_service.hpp"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+venus::executor_options shared_timers(venus::timer_service & service)
+{
+    venus::executor_options options;
+    options.m_timer_service = &service;
+    return options;
+}
+
+} // namespace
+
+TEST(timer_service, calls_run_on_their_executor)
+{
+    venus::timer_service service;
+    venus::executor first(shared_timers(service));
+    venus::executor second(shared_timers(service));
+
+    std::promise<bool> first_done;
+    std::promise<bool> second_done;
+    auto start = venus::clock_t::now();
+    first.call_after(2ms, [&] { first_done.set_value(first.is_executor_thread()); });
+    second.call_after(1ms, [&] { second_done.set_value(second.is_executor_thread()); });
+
+    ASSERT_TRUE(second_done.get_future().get());
+    ASSERT_TRUE(first_done.get_future().get());
+    ASSERT_GE(venus::clock_t::now() - start, 2ms);
+    ASSERT_EQ(first.stats().m_scheduled_calls_executed, 1);
+}
+
+TEST(timer_service, cancel_and_repeat)
+{
+    venus::timer_service service;
+    venus::executor executor(shared_timers(service));
+    std::atomic<bool> fired(false);
+    std::promise<void> done;
+    auto count = std::make_unique<int>(0);
+    std::unique_ptr<venus::scheduled_call> repeating;
+
+    auto cancelled = executor.call_after(1ms, [&] { fired = true; });
+    cancelled.cancel();
+
+    executor.call([&] {
+        repeating = std::make_unique<venus::scheduled_call>(executor.call_every(100us, [&, count = std::move(count)] {
+            if (++*count == 3)
+            {
+                repeating->cancel();
+                done.set_value();
+            }
+        }));
+    });
+    done.get_future().wait();
+
+    // the cancelled calls are dropped at their next tick
+    std::this_thread::sleep_for(5ms);
+    executor.synchronize();
+    ASSERT_FALSE(fired);
+    ASSERT_EQ(service.size(), 0);
+}
+
+// a call cancelled on the executor thread does not run, also when the service already added it as a task
+TEST(timer_service, cancel_after_dispatch)
+{
+    venus::timer_service service;
+    venus::executor executor(shared_timers(service));
+    std::atomic<bool> fired(false);
+    std::promise<void> release;
+    auto released = release.get_future().share();
+
+    auto call = executor.call_after(1ms, [&] { fired = true; });
+    executor.add([&, released] {
+        released.wait();
+        call.cancel();
+    });
+    std::this_thread::sleep_for(5ms);
+    release.set_value();
+    executor.synchronize();
+    ASSERT_FALSE(fired);
+}
+
+TEST(timer_service, coalesce_missed_ticks)
+{
+    venus::timer_service service;
+    venus::executor executor(shared_timers(service));
+    std::vector<std::size_t> missed;
+    std::promise<void> done;
+    auto scheduled_call = executor.call_every(5ms, venus::missed_tick_policy::coalesce, [&](std::size_t missed_ticks) {
+        missed.push_back(missed_ticks);
+        if (missed.size() == 1)
+        {
+            std::this_thread::sleep_for(28ms);
+        }
+        else if (missed.size() == 2)
+        {
+            done.set_value();
+        }
+    });
+    done.get_future().wait();
+    scheduled_call.cancel();
+    executor.synchronize();
+
+    ASSERT_GE(missed.size(), 2);
+    ASSERT_EQ(missed[0], 0);
+    ASSERT_GE(missed[1], 4);
+}
+
+// calls cancelled on the executor are reclaimed by the service long before their deadline, like re-armed idle
+// timeouts, only less than 1024 cancelled calls (the minimum to reclaim in bulk) can be left until they are due
+TEST(timer_service, reclaim_cancelled_calls)
+{
+    venus::timer_service service;
+    venus::executor executor(shared_timers(service));
+    auto value = std::make_shared<int>(0);
+
+    std::vector<venus::scheduled_call> calls;
+    for (int i = 0; i < 4000; ++i)
+    {
+        calls.push_back(executor.call_after(1h, [value] {}));
+    }
+    for (int i = 0; i < 1000 && service.size() != 4000; ++i)
+    {
+        std::this_thread::sleep_for(1ms);
+    }
+    ASSERT_EQ(service.size(), 4000);
+
+    for (auto & call : calls)
+    {
+        call.cancel();
+    }
+
+    // the functions of the reclaimed calls are destroyed
+    auto reclaimed = [&] { return service.size() < 1024 && value.use_count() == static_cast<long>(service.size()) + 1; };
+    for (int i = 0; i < 1000 && !reclaimed(); ++i)
+    {
+        std::this_thread::sleep_for(1ms);
+    }
+    ASSERT_TRUE(reclaimed());
+
+    // the ids of the reclaimed calls were released and are re-used
+    std::promise<void> done;
+    executor.call_after(1ms, [&] { done.set_value(); });
+    done.get_future().wait();
+}
+
+// the calls of a destroyed executor are removed, the service keeps running the calls of the others
+TEST(timer_service, remove_owner)
+{
+    venus::timer_service service;
+    venus::executor survivor(shared_timers(service));
+    {
+        venus::executor executor(shared_timers(service));
+        executor.call_every(100us, [] {});
+        executor.call_after(1h, [] {});
+        executor.synchronize();
+    }
+    ASSERT_EQ(service.size(), 0);
+
+    std::promise<void> done;
+    survivor.call_after(1ms, [&] { done.set_value(); });
+    done.get_future().wait();
+}
+
+// with a minimum slack, the deadlines of many executors are due together in a few wakeups of the service thread
+TEST(timer_service, aggregates_wakeups)
+{
+    venus::timer_service_options options;
+    options.m_minimum_slack = 100ms;
+    venus::timer_service service(options);
+
+    std::vector<std::unique_ptr<venus::executor>> executors;
+    for (int i = 0; i < 8; ++i)
+    {
+        executors.push_back(std::make_unique<venus::executor>(shared_timers(service)));
+    }
+
+    std::atomic<int> count = {0};
+    std::promise<void> done;
+    for (int i = 0; i < 32; ++i)
+    {
+        executors[static_cast<std::size_t>(i) % executors.size()]->call_after(std::chrono::milliseconds(i), [&] {
+            if (++count == 32)
+            {
+                done.set_value();
+            }
+        });
+    }
+    done.get_future().wait();
+    ASSERT_LE(service.wakeups(), 2);
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2025 Jan Wilmans
+ */
+
+#include "gmock/gmock.h"
+#include <gtest/gtest.h>
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "executor/synchronized_queue.hpp"
+#include "executor/unique_task.hpp"
+
+TEST(unique_task, empty)
+{
+    venus::unique_task task;
+    ASSERT_FALSE(task);
+    ASSERT_THROW(task(), std::bad_function_call);
+
+    task = [] {};
+    ASSERT_TRUE(task);
+    task = nullptr;
+    ASSERT_FALSE(task);
+}
+
+namespace {
+
+void do_nothing()
+{
+}
+
+} // namespace
+
+// a null function pointer or an empty std::function gives an empty task, like std::function, not one that crashes
+TEST(unique_task, empty_callables)
+{
+    void (*null_function)() = nullptr;
+    venus::unique_task from_pointer(null_function);
+    ASSERT_FALSE(from_pointer);
+    ASSERT_THROW(from_pointer(), std::bad_function_call);
+
+    venus::unique_task from_function(std::function<void()>{});
+    ASSERT_FALSE(from_function);
+    ASSERT_THROW(from_function(), std::bad_function_call);
+
+    auto resource = venus::new_delete_resource();
+    venus::unique_task from_resource(std::allocator_arg, resource, std::function<void()>{});
+    ASSERT_FALSE(from_resource);
+
+    venus::unique_task task = do_nothing;
+    ASSERT_TRUE(task);
+    task();
+    task = &do_nothing;
+    ASSERT_TRUE(task);
+    task = std::function<void()>(do_nothing);
+    ASSERT_TRUE(task);
+    task = null_function;
+    ASSERT_FALSE(task);
+}
+
+TEST(unique_task, move_only_capture)
+{
+    auto value = std::make_unique<int>(42);
+    int result = 0;
+    venus::unique_task task([value = std::move(value), &result] { result = *value; });
+    venus::unique_task moved(std::move(task));
+    ASSERT_FALSE(task);
+    moved();
+    ASSERT_EQ(result, 42);
+}
+
+TEST(unique_task, inline_storage)
+{
+    std::array<char, venus::unique_task::inline_capacity> small = {};
+    std::array<char, venus::unique_task::inline_capacity + 1> large = {};
+    auto small_lambda = [small] { (void)small; };
+    auto large_lambda = [large] { (void)large; };
+
+    ASSERT_EQ(sizeof(venus::unique_task), 64);
+    ASSERT_TRUE(venus::unique_task::stored_inline<decltype(small_lambda)>());
+    ASSERT_FALSE(venus::unique_task::stored_inline<decltype(large_lambda)>());
+}
+
+// captures are destroyed exactly once, both when stored inline and on the heap
+TEST(unique_task, destroys_captures)
+{
+    auto value = std::make_shared<int>(1);
+    std::array<char, venus::unique_task::inline_capacity> large = {};
+    {
+        venus::unique_task small_task([value] {});
+        venus::unique_task large_task([value, large] { (void)large; });
+        ASSERT_EQ(value.use_count(), 3);
+
+        venus::unique_task other;
+        other = std::move(small_task);
+        other = std::move(large_task);
+        ASSERT_EQ(value.use_count(), 2);
+    }
+    ASSERT_EQ(value.use_count(), 1);
+}
+
+TEST(unique_task, synchronized_queue)
+{
+    venus::synchronized_queue<venus::unique_task> queue;
+    std::string result;
+    auto text = std::make_unique<std::string>("one");
+    queue.push([text = std::move(text), &result] { result += *text; });
+    queue.push([&result] { result += "two"; });
+
+    queue.pop()();
+    queue.pop()();
+    ASSERT_EQ(result, "onetwo");
+}